@@ -0,0 +1,321 @@
+#define _POSIX_C_SOURCE 200809L // for clock_gettime
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "GameHandler.h"
+
+/*
+A headless benchmark of the computer move search (no SDL): searches a fixed suite of positions at every
+difficulty level, and prints the results as JSON - the chosen move, the nodes, the time to reach the depth
+and the nodes per second of each search, and a signature of all the node counts and moves. With one thread
+the search is deterministic, so a change of the signature means that the search itself has changed.
+The suite is run several times, and the fastest run of each search is kept, so the speed is less noisy
+(the runs of a search are spread over the whole benchmark, so a slow period of the machine doesn't slow
+down all of them).
+
+In compare mode, the results are compared to a baseline (the JSON output of an earlier run): a changed
+node count or move, a drop of the total nodes per second beyond the tolerance, and a search that is not in
+the baseline, are reported as regressions. The speed of a single search is too noisy to fail the comparison,
+so its drop beyond the tolerance is only reported.
+*/
+
+#define BENCH_MAX_LINE_LENGTH 256
+#define BENCH_MAX_NAME_LENGTH 32
+#define BENCH_MAX_MOVE_LENGTH 16
+#define BENCH_DEFAULT_TOLERANCE_PERCENT 20
+#define BENCH_DEFAULT_RUNS_NUMBER 5
+#define BENCH_MIN_COMPARED_TIME_MS 50.0 // shorter searches are too noisy for comparing the speed
+#define BENCH_MIN_GATED_TIME_MS 200.0 // the minimum total time for a drop of the total speed to be a regression
+
+/*
+A position of the suite, in FEN notation (only the pieces and the side to move are used).
+*/
+typedef struct bench_position_t {
+	char * name;
+	char * fen;
+} BenchPosition;
+
+typedef struct bench_result_t {
+	char name[BENCH_MAX_NAME_LENGTH];
+	int level;
+	char move[BENCH_MAX_MOVE_LENGTH];
+	long long nodes; // the nodes of the main search and of the quiescence search
+	long long quiescenceNodes;
+	double timeMs;
+	long long nodesPerSecond;
+} BenchResult;
+
+static BenchPosition benchPositions[] = {
+	{ "opening", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w" },
+	{ "middlegame-italian", "r1bq1rk1/pppp1ppp/2n2n2/2b1p3/2B1P3/3P1N2/PPP2PPP/RNBQ1RK1 w" },
+	{ "middlegame-kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w" },
+	{ "tactical-mate-in-one", "r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w" },
+	{ "tactical-wac001", "2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w" },
+	{ "endgame-rook", "8/5k2/8/3p4/8/2K5/4R3/8 w" },
+	{ "endgame-pawns", "8/8/1p3k2/p1p5/P1P5/1P3K2/8/8 w" },
+	{ "endgame-rook-pawns", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w" }
+};
+
+#define BENCH_POSITIONS_NUMBER ((int)(sizeof(benchPositions) / sizeof(BenchPosition)))
+
+static double benchGetTimeMs() {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/*
+Sets the board and the current player of the game from a FEN string, and syncs the state of the game.
+In FEN, white pieces are uppercase and the rows are given from the last one, and a pawn is 'p'.
+*/
+static void benchSetPosition(Game * game, char * fen) {
+	int row = BOARD_ROWS_NUMBER - 1, col = 0;
+	char piece;
+
+	for (; *fen != ' '; fen++) {
+		if (*fen == '/') {
+			row--;
+			col = 0;
+		}
+		else if (*fen >= '1' && *fen <= '8') {
+			for (int i = 0; i < *fen - '0'; i++) game->gameBoard[row][col++] = BOARD_EMPTY_CELL;
+		}
+		else {
+			piece = (tolower(*fen) == 'p') ? PIECE_PAWN : tolower(*fen);
+			game->gameBoard[row][col++] = isupper(*fen) ? piece : toupper(piece);
+		}
+	}
+
+	if ((fen[1] == 'b') != (gameGetCurrentPlayer(game) == Black)) gameChangePlayer(game);
+
+	gameSyncBoardState(game);
+}
+
+/*
+Searches the position at the given level, from an empty transposition table so the search is reproducible.
+On the first run the result is set, and on the next runs it's replaced only if the search is faster.
+Returns false if the game couldn't be created.
+*/
+static bool benchRunSearch(BenchPosition * position, int level, bool isFirstRun, BenchResult * result) {
+	GameHandler * gh = gameHandlerNewGame(gameHandlerGetDefaultSettings());
+	MinimaxStats stats;
+	Move move;
+	double startMs, timeMs;
+
+	if (gh == NULL) return false;
+
+	benchSetPosition(gh->game, position->fen);
+	minimaxClearTranspositionTable();
+
+	startMs = benchGetTimeMs();
+	move = minimaxSuggestMove(gh->game, level);
+	timeMs = benchGetTimeMs() - startMs;
+
+	gameHandlerDestroy(gh);
+
+	// with more threads the node counts of the runs differ, so the nodes are of the fastest run too
+	if (!isFirstRun && timeMs >= result->timeMs) return true;
+
+	result->timeMs = timeMs;
+	stats = minimaxGetLastSearchStats();
+
+	strncpy(result->name, position->name, BENCH_MAX_NAME_LENGTH - 1);
+	result->name[BENCH_MAX_NAME_LENGTH - 1] = '\0';
+	result->level = level;
+	// the rows are printed as chars too, so the length is known to fit
+	sprintf(result->move, "<%c,%c> -> <%c,%c>", move.oldSquare.row + '1', move.oldSquare.col + 'A',
+		move.newSquare.row + '1', move.newSquare.col + 'A');
+	result->nodes = stats.nodes + stats.quiescenceNodes;
+	result->quiescenceNodes = stats.quiescenceNodes;
+	result->nodesPerSecond = result->timeMs > 0 ? (long long)(result->nodes * 1000.0 / result->timeMs) : 0;
+
+	return true;
+}
+
+/*
+Adds the node count and the move of the result to the signature (FNV-1a).
+*/
+static uint64_t benchUpdateSignature(uint64_t signature, BenchResult * result) {
+	char text[BENCH_MAX_LINE_LENGTH];
+
+	// the lengths are bounded, so the text is known to fit
+	sprintf(text, "%.*s/%d/%.*s/%lld", BENCH_MAX_NAME_LENGTH - 1, result->name, result->level,
+		BENCH_MAX_MOVE_LENGTH - 1, result->move, result->nodes);
+
+	for (char * c = text; *c != '\0'; c++) {
+		signature ^= (unsigned char)*c;
+		signature *= 1099511628211ULL;
+	}
+
+	return signature;
+}
+
+static void benchPrintResult(BenchResult * result, bool isLast) {
+	printf("    {\"position\": \"%s\", \"level\": %d, \"move\": \"%s\", \"nodes\": %lld, \"quiescenceNodes\": %lld, "
+		"\"timeMs\": %.3f, \"nps\": %lld}%s\n", result->name, result->level, result->move, result->nodes,
+		result->quiescenceNodes, result->timeMs, result->nodesPerSecond, isLast ? "" : ",");
+}
+
+/*
+Reads a result line of a JSON output. Returns false if the line is not a result.
+*/
+static bool benchParseResult(char * line, BenchResult * result) {
+	return sscanf(line, " {\"position\": \"%31[^\"]\", \"level\": %d, \"move\": \"%15[^\"]\", \"nodes\": %lld, "
+		"\"quiescenceNodes\": %lld, \"timeMs\": %lf, \"nps\": %lld", result->name, &result->level, result->move,
+		&result->nodes, &result->quiescenceNodes, &result->timeMs, &result->nodesPerSecond) == 7;
+}
+
+/*
+Loads the results of a baseline file. Returns the number of results, or -1 if the file can't be read.
+*/
+static int benchLoadBaseline(char * path, BenchResult * results, int maxResults) {
+	char line[BENCH_MAX_LINE_LENGTH];
+	int size = 0;
+	FILE * fh = fopen(path, "r");
+
+	if (fh == NULL) return -1;
+
+	while (size < maxResults && fgets(line, BENCH_MAX_LINE_LENGTH, fh) != NULL) {
+		if (benchParseResult(line, &results[size])) size++;
+	}
+
+	fclose(fh);
+
+	return size;
+}
+
+/*
+Compares a result to its baseline result, prints the regressions, and returns their number.
+A drop of the speed is a regression only for the total, and is printed as a note for a single search.
+*/
+static int benchCompareResult(BenchResult * result, BenchResult * baseline, int tolerancePercent) {
+	int regressions = 0;
+
+	if (result->nodes != baseline->nodes || strcmp(result->move, baseline->move) != 0) {
+		printf("REGRESSION %s level %d: nodes %lld -> %lld, move %s -> %s\n", result->name, result->level,
+			baseline->nodes, result->nodes, baseline->move, result->move);
+		regressions++;
+	}
+
+	if (result->timeMs < BENCH_MIN_COMPARED_TIME_MS || baseline->timeMs < BENCH_MIN_COMPARED_TIME_MS ||
+		result->nodesPerSecond * 100 >= baseline->nodesPerSecond * (100 - tolerancePercent)) return regressions;
+
+	if (result->level == 0 && result->timeMs >= BENCH_MIN_GATED_TIME_MS) {
+		printf("REGRESSION %s: nps %lld -> %lld\n", result->name, baseline->nodesPerSecond, result->nodesPerSecond);
+		regressions++;
+	}
+	else {
+		printf("SLOWER %s level %d: nps %lld -> %lld\n", result->name, result->level,
+			baseline->nodesPerSecond, result->nodesPerSecond);
+	}
+
+	return regressions;
+}
+
+static void printUsage(char * name) {
+	printf("USAGE: %s [-levels <max level>] [-threads <n>] [-runs <n>] [-compare <baseline file> [-tolerance <percent>]]\n",
+		name);
+}
+
+int main(int argc, char * argv[]) {
+	BenchResult results[BENCH_POSITIONS_NUMBER * GameDifficultyExpert + 1]; // and the total
+	BenchResult baseline[BENCH_POSITIONS_NUMBER * GameDifficultyExpert + 1];
+	BenchResult total = { .name = "total", .level = 0, .move = "-", .nodes = 0, .quiescenceNodes = 0, .timeMs = 0 };
+	char * baselinePath = NULL;
+	int maxLevel = GameDifficultyExpert, tolerancePercent = BENCH_DEFAULT_TOLERANCE_PERCENT;
+	int runsNumber = BENCH_DEFAULT_RUNS_NUMBER;
+	int size = 0, baselineSize = 0, regressions = 0;
+	uint64_t signature = 14695981039346656037ULL;
+	bool error = false, found;
+
+	for (int i = 1; i < argc && !error; i++) {
+		if (strcmp(argv[i], "-levels") == 0 && i + 1 < argc) maxLevel = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc) error = !minimaxSetThreadsNumber(atoi(argv[++i]));
+		else if (strcmp(argv[i], "-runs") == 0 && i + 1 < argc) runsNumber = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-compare") == 0 && i + 1 < argc) baselinePath = argv[++i];
+		else if (strcmp(argv[i], "-tolerance") == 0 && i + 1 < argc) tolerancePercent = atoi(argv[++i]);
+		else error = true;
+	}
+
+	if (error || maxLevel < GameDifficultyAmateur || maxLevel > GameDifficultyExpert ||
+		tolerancePercent < 0 || tolerancePercent > 100 || runsNumber < 1) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	if (baselinePath != NULL) {
+		baselineSize = benchLoadBaseline(baselinePath, baseline, BENCH_POSITIONS_NUMBER * GameDifficultyExpert + 1);
+
+		if (baselineSize < 0) {
+			printf("ERROR: failed to read the baseline file \"%s\".\n", baselinePath);
+			return 1;
+		}
+	}
+
+	for (int run = 0; run < runsNumber; run++) {
+		size = 0;
+
+		for (int i = 0; i < BENCH_POSITIONS_NUMBER; i++) {
+			for (int level = GameDifficultyAmateur; level <= maxLevel; level++) {
+				if (!benchRunSearch(&benchPositions[i], level, run == 0, &results[size++])) {
+					printf("ERROR: failed to create the game.\n");
+					minimaxFreeResources();
+					return 1;
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < size; i++) {
+		signature = benchUpdateSignature(signature, &results[i]);
+		total.nodes += results[i].nodes;
+		total.quiescenceNodes += results[i].quiescenceNodes;
+		total.timeMs += results[i].timeMs;
+	}
+
+	total.nodesPerSecond = total.timeMs > 0 ? (long long)(total.nodes * 1000.0 / total.timeMs) : 0;
+
+	minimaxFreeResources();
+
+	// the profile goes to stderr, so the output is still valid JSON
+	if (profilerIsEnabled()) profilerPrintToFileHandler(stderr);
+
+	if (baselinePath == NULL) {
+		printf("{\n  \"results\": [\n");
+		for (int i = 0; i < size; i++) benchPrintResult(&results[i], i == size - 1);
+		printf("  ],\n  \"total\":\n");
+		benchPrintResult(&total, false);
+		printf("  \"runs\": %d,\n", runsNumber);
+		printf("  \"signature\": \"%016llx\"\n}\n", (unsigned long long)signature);
+
+		return 0;
+	}
+
+	// compare mode - the total is a result of the baseline too (with level 0), but it's comparable only
+	// if the same searches were run
+	if (size + 1 == baselineSize) results[size++] = total;
+
+	for (int i = 0; i < size; i++) {
+		found = false;
+
+		for (int j = 0; j < baselineSize && !found; j++) {
+			if (strcmp(results[i].name, baseline[j].name) == 0 && results[i].level == baseline[j].level) {
+				found = true;
+				regressions += benchCompareResult(&results[i], &baseline[j], tolerancePercent);
+			}
+		}
+
+		if (!found) {
+			printf("NOT IN BASELINE %s level %d\n", results[i].name, results[i].level);
+			regressions++;
+		}
+	}
+
+	printf("%d regressions, nps %lld (signature %016llx)\n", regressions, total.nodesPerSecond,
+		(unsigned long long)signature);
+
+	return regressions > 0 ? 1 : 0;
+}
@@ -3,13 +3,17 @@
 GhSettings settings;
 GameHandler * gh = NULL;
 bool gameBoardChanged = false;
+bool printSearchStats = false; // print the statistics of the search after each computer move
 
 static void errorLibFunc(char * funcName) {
 	printf(ERROR_LIB_FUNC, funcName);
 }
 
 static void consoleGameFreeAndExit() {
+	if (profilerIsEnabled()) profilerPrintToFileHandler(stdout);
+
 	gameHandlerDestroy(gh);
+	minimaxFreeResources();
 	exit(0);
 }
 
@@ -229,7 +233,7 @@ static void consoleGameHandleCmdMove(Command parsedCmd) {
 	}
 	
 	// convert the characters into the corresponding int, and call setMove
-	switch (gameSetMove(gh->game, consoleGameConvertArgsToBoardSquare(parsedCmd.arg1, parsedCmd.arg2), 
+	switch (gameHandlerSetUserMove(gh, consoleGameConvertArgsToBoardSquare(parsedCmd.arg1, parsedCmd.arg2), 
 		consoleGameConvertArgsToBoardSquare(parsedCmd.arg3, parsedCmd.arg4))) {
 
 	case GAME_INVALID_SQUARE:
@@ -253,8 +257,6 @@ static void consoleGameHandleCmdMove(Command parsedCmd) {
 	default:
 		break;
 	}
-
-	gameHandlerGameElementAddedToHistory(gh);
 }
 
 static void gameConsolePrintBoardSquare(BoardSquare s) {
@@ -324,7 +326,7 @@ static void consoleGameHandleCmdUndoMove() {
 
 		// save history element and undo move
 		histElem = arrayListGetLast(gh->game->history);
-		gameUndoPrevMove(gh->game);
+		gameHandlerUndoPrevMove(gh);
 
 		// print the undo
 		printf("Undo move for %s player: ", gameGetCurrentPlayerColorText(gh->game));
@@ -362,6 +364,43 @@ static char * consoleGameGetPieceText(char piece) {
 	return ""; // for compilation
 }
 
+/*
+Prints the statistics of the search of the last computer move.
+*/
+static void consoleGamePrintSearchStats() {
+	MinimaxStats stats = gameHandlerGetLastSearchStats(gh);
+
+	printf("Search: depth %d, max ply %d, %lldms\n", stats.depth, stats.maxPly, stats.timeMs);
+	printf("  nodes %lld, leaves %lld, quiescence nodes %lld\n", stats.nodes, stats.leafNodes, stats.quiescenceNodes);
+	printf("  beta cutoffs %lld, by the first move %.1f%%\n", stats.betaCutoffs,
+		stats.betaCutoffs > 0 ? stats.firstMoveCutoffs * 100.0 / stats.betaCutoffs : 0.0);
+	printf("  table probes %lld, hits %.1f%%\n", stats.tableProbes,
+		stats.tableProbes > 0 ? stats.tableHits * 100.0 / stats.tableProbes : 0.0);
+
+	printf("  iterations (ms):");
+	for (int i = 0; i < stats.iterationsNumber; i++) printf(" %lld", stats.iterationTimesMs[i]);
+	printf("\n");
+
+	printf("  best line:");
+	for (int i = 0; i < stats.bestLineLength; i++) {
+		printf(" ");
+		gameConsolePrintBoardSquare(gameMoveGetSource(stats.bestLine[i]));
+		printf("->");
+		gameConsolePrintBoardSquare(gameMoveGetDestination(stats.bestLine[i]));
+	}
+	printf("\n");
+}
+
+static void consoleGameHandleCmdSearchStats() {
+	printSearchStats = !printSearchStats;
+
+	printf("Search statistics are %s\n", printSearchStats ? "on" : "off");
+}
+
+static void consoleGameHandleCmdProfile() {
+	profilerPrintToFileHandler(stdout);
+}
+
 static void consoleGameHandleComputerMove() {
 	HistoryElement histElemComputerMove;
 
@@ -377,6 +416,8 @@ static void consoleGameHandleComputerMove() {
 	gameConsolePrintBoardSquare(histElemComputerMove.newSquare);
 	printf("\n");
 
+	if (printSearchStats) consoleGamePrintSearchStats();
+
 	consoleGameBoardChanged();
 }
 
@@ -390,6 +431,16 @@ static void consoleGameHandleCmdSave(Command parsedCmd) {
 	else printf("File cannot be created or modified\n");
 }
 
+static void consoleGameHandleCmdExportLog(Command parsedCmd) {
+	if (!parsedCmd.validArg) {
+		consoleGameHandleCmdInvalid();
+		return;
+	}
+
+	if (gameHandlerExportMoveLog(gh, parsedCmd.path)) printf("Move log exported to: %s\n", parsedCmd.path);
+	else printf("File cannot be created or modified\n");
+}
+
 /*
 Settings state must be run before game state.
 @param gameLoaded - indicates whether the game was loaded with the load command
@@ -448,6 +499,15 @@ static CgMsg consoleGameRunGameState(bool gameLoaded) {
 			case CMD_TYPE_SAVE:
 				consoleGameHandleCmdSave(parsedCmd);
 				break;
+			case CMD_TYPE_EXPORT_LOG:
+				consoleGameHandleCmdExportLog(parsedCmd);
+				break;
+			case CMD_TYPE_SEARCH_STATS:
+				consoleGameHandleCmdSearchStats();
+				break;
+			case CMD_TYPE_PROFILE:
+				consoleGameHandleCmdProfile();
+				break;
 			case CMD_TYPE_INVALID_LINE:
 			default:
 				consoleGameHandleCmdInvalid();
@@ -88,8 +88,11 @@ static void setCommandType(Command * cmd, char * token) {
 	else if (strcmp(token, CMD_MOVE) == 0) cmd->cmdType = CMD_TYPE_MOVE;
 	else if (strcmp(token, CMD_GET_MOVES) == 0) cmd->cmdType = CMD_TYPE_GET_MOVES;
 	else if (strcmp(token, CMD_SAVE) == 0) cmd->cmdType = CMD_TYPE_SAVE;
+	else if (strcmp(token, CMD_EXPORT_LOG) == 0) cmd->cmdType = CMD_TYPE_EXPORT_LOG;
 	else if (strcmp(token, CMD_UNDO) == 0) cmd->cmdType = CMD_TYPE_UNDO;
 	else if (strcmp(token, CMD_RESET) == 0) cmd->cmdType = CMD_TYPE_RESET;
+	else if (strcmp(token, CMD_SEARCH_STATS) == 0) cmd->cmdType = CMD_TYPE_SEARCH_STATS;
+	else if (strcmp(token, CMD_PROFILE) == 0) cmd->cmdType = CMD_TYPE_PROFILE;
 
 	else cmd->cmdType = CMD_TYPE_INVALID_LINE;
 }
@@ -167,6 +170,7 @@ static void setCommandArguments(Command *cmd, char *token) {
 
 	case CMD_TYPE_LOAD:
 	case CMD_TYPE_SAVE:
+	case CMD_TYPE_EXPORT_LOG:
 		cmd->path = token;
 		break;
 
@@ -25,8 +25,11 @@
 #define CMD_MOVE "move"
 #define CMD_GET_MOVES "get_moves"
 #define CMD_SAVE "save"
+#define CMD_EXPORT_LOG "export_log"
 #define CMD_UNDO "undo"
 #define CMD_RESET "reset"
+#define CMD_SEARCH_STATS "search_stats"
+#define CMD_PROFILE "profile"
 
 //a type used to represent a command
 typedef enum {
@@ -47,8 +50,11 @@ typedef enum {
 	CMD_TYPE_MOVE,
 	CMD_TYPE_GET_MOVES,
 	CMD_TYPE_SAVE,
+	CMD_TYPE_EXPORT_LOG,
 	CMD_TYPE_UNDO,
-	CMD_TYPE_RESET
+	CMD_TYPE_RESET,
+	CMD_TYPE_SEARCH_STATS,
+	CMD_TYPE_PROFILE
 } COMMAND_TYPE;
 
 // encapsulation of a parsed line
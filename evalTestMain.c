@@ -0,0 +1,95 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Game.h"
+
+/*
+A headless test of the evaluation (no SDL): plays random games from the initial position, and checks
+that every position and its colour-flipped mirror (the rows flipped and the colours of the pieces swapped)
+are evaluated the same, with the players swapped. Exits with 1 if any position is not.
+*/
+
+#define EVAL_TEST_GAMES_NUMBER 200
+#define EVAL_TEST_MAX_PLIES 60 // less than GAME_MAX_SEARCH_DEPTH, so all the moves fit in the undo stack
+#define EVAL_TEST_SEED 1
+
+/*
+Returns the score of the position from the point of view of the player (the material plus the positional score).
+*/
+static int evalTestGetScore(Game * game, ChessPlayer player) {
+	ChessPlayer opponent = player == White ? Black : White;
+
+	return (game->material[player] - game->material[opponent]) * EVALUATION_PAWN_VALUE +
+		evaluationGetPositionalScore(&game->evaluation, player);
+}
+
+/*
+Sets mirror to the colour-flipped mirror of the position of game.
+*/
+static void evalTestMirror(Game * game, Game * mirror) {
+	for (int row = 0; row < BOARD_ROWS_NUMBER; row++) {
+		for (int col = 0; col < BOARD_COLUMNS_NUMBER; col++) {
+			char piece = game->gameBoard[BOARD_ROWS_NUMBER - 1 - row][col];
+
+			mirror->gameBoard[row][col] = islower(piece) ? toupper(piece) : tolower(piece);
+		}
+	}
+
+	mirror->currentPlayer = game->currentPlayer == White ? Black : White;
+	gameSyncBoardState(mirror);
+}
+
+/*
+Returns true iff the position of game and its mirror are evaluated the same, and prints them if not.
+*/
+static bool evalTestCheckPosition(Game * game, Game * mirror, int gameIndex, int ply) {
+	int score = evalTestGetScore(game, White), mirrorScore;
+
+	evalTestMirror(game, mirror);
+	mirrorScore = evalTestGetScore(mirror, Black);
+	if (score == mirrorScore && evalTestGetScore(mirror, White) == -score) return true;
+
+	printf("FAILED: game %d ply %d: the score of white is %d, and of black in the mirror %d\n",
+		gameIndex, ply, score, mirrorScore);
+	for (int row = BOARD_ROWS_NUMBER - 1; row >= 0; row--) {
+		printf("%.*s\n", BOARD_COLUMNS_NUMBER, game->gameBoard[row]);
+	}
+
+	return false;
+}
+
+int main() {
+	Game * game = gameCreate(1), * mirror = gameCreate(1);
+	MoveList moveList;
+	int positions = 0, failures = 0;
+
+	if (game == NULL || mirror == NULL) {
+		printf("ERROR: failed to create the game.\n");
+		gameDestroy(game);
+		gameDestroy(mirror);
+		return 1;
+	}
+
+	srand(EVAL_TEST_SEED);
+
+	for (int i = 0; i < EVAL_TEST_GAMES_NUMBER; i++) {
+		for (int ply = 0; ply <= EVAL_TEST_MAX_PLIES; ply++) {
+			positions++;
+			if (!evalTestCheckPosition(game, mirror, i, ply)) failures++;
+
+			gameGenerateMoves(game, &moveList);
+			if (moveList.size == 0 || ply == EVAL_TEST_MAX_PLIES) break;
+
+			gameMakeMove(game, moveList.moves[rand() % moveList.size]);
+		}
+
+		while (game->undoStackSize > 0) gameUnmakeMove(game);
+	}
+
+	printf("%d positions, %d failed\n", positions, failures);
+
+	gameDestroy(game);
+	gameDestroy(mirror);
+
+	return failures > 0 ? 1 : 0;
+}
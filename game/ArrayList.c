@@ -14,49 +14,60 @@ ArrayList* arrayListCreate(int maxSize) {
 
 	al->maxSize = maxSize;
 	al->actualSize = 0;
+	al->head = 0;
 
 	return al;
 }
 
-
 /*
-* Copies array elements to other array.
-* Assumes number_of_elements < dst.length, src.length
+Returns the position in the elements array of the element at the given (0-based) index of the list.
+The index may be -1 or actualSize, for the positions just before and just after the list.
 */
+static int arrayListGetPosition(ArrayList* src, int index) {
+	int position = src->head + index;
 
-/*
-static void copyElements(int* src, int* dst, int number_of_elements) {
-	int i;
+	if (position < 0) return position + src->maxSize;
+	if (position >= src->maxSize) return position - src->maxSize;
 
-	for (i = 0; i < number_of_elements; i++) {
-		dst[i] = src[i];
-	}
+	return position;
 }
 
-SPArrayList* spArrayListCopy(SPArrayList* src) {
-	if ((void*)src == NULL) {
-		return NULL;
-	}
+/*
+Copies the elements of src to the beginning of the elements array of dst, in order.
+Assumes they fit in the capacity of dst.
+*/
+static void arrayListCopyElements(ArrayList* src, ArrayList* dst) {
+	// the elements may wrap around the end of the array, so they are copied in two parts
+	int firstPartSize = src->maxSize - src->head < src->actualSize ? src->maxSize - src->head : src->actualSize;
 
-	SPArrayList *al = (SPArrayList*)(malloc(sizeof(SPArrayList)));
-	if ((void*)al == NULL) {
-		return NULL;
-	}
+	memcpy(dst->elements, src->elements + src->head, sizeof(HistoryElement) * firstPartSize);
+	memcpy(dst->elements + firstPartSize, src->elements, sizeof(HistoryElement) * (src->actualSize - firstPartSize));
+
+	dst->actualSize = src->actualSize;
+	dst->head = 0;
+}
 
-	al->elements = (int*)(malloc(sizeof(int) * src->maxSize));
-	if ((void*)(al->elements) == NULL) {
-		free(al);
-		return NULL;
-	}
 
-	copyElements(src->elements, al->elements, src->actualSize);
+ArrayList* arrayListCopy(ArrayList* src) {
+	if ((void*)src == NULL) return NULL;
+
+	ArrayList *al = arrayListCreate(src->maxSize);
+	if ((void*)al == NULL) return NULL;
 
-	al->maxSize = src->maxSize;
-	al->actualSize = src->actualSize;
+	arrayListCopyElements(src, al);
 
 	return al;
 }
-*/
+
+ARRAY_LIST_MESSAGE arrayListCopyInto(ArrayList* src, ArrayList* dst) {
+	if ((void*)src == NULL || (void*)dst == NULL) return ARRAY_LIST_INVALID_ARGUMENT;
+
+	if (src->actualSize > dst->maxSize) return ARRAY_LIST_FULL;
+
+	arrayListCopyElements(src, dst);
+
+	return ARRAY_LIST_SUCCESS;
+}
 
 void arrayListDestroy(ArrayList* src) {
 	if ((void*)src == NULL) return;
@@ -91,13 +102,23 @@ ARRAY_LIST_MESSAGE arrayListAddAt(ArrayList* src, HistoryElement elem, int index
 
 	if (src->actualSize == src->maxSize) return ARRAY_LIST_FULL;
 
-	// shift the array!
-	for (int i = src->actualSize - 1; i >= index; i--) {
-		(src->elements)[i + 1] = (src->elements)[i];
+	// shift the shorter side of the array - the elements before the index one step back,
+	// or the elements at and after the index one step forward
+	if (index < src->actualSize / 2) {
+		src->head = arrayListGetPosition(src, -1);
+
+		for (int i = 0; i < index; i++) {
+			(src->elements)[arrayListGetPosition(src, i)] = (src->elements)[arrayListGetPosition(src, i + 1)];
+		}
+	}
+	else {
+		for (int i = src->actualSize - 1; i >= index; i--) {
+			(src->elements)[arrayListGetPosition(src, i + 1)] = (src->elements)[arrayListGetPosition(src, i)];
+		}
 	}
 
 	// insert new val
-	(src->elements)[index] = elem;
+	(src->elements)[arrayListGetPosition(src, index)] = elem;
 	(src->actualSize)++;
 
 	return ARRAY_LIST_SUCCESS;
@@ -123,9 +144,19 @@ ARRAY_LIST_MESSAGE arrayListRemoveAt(ArrayList* src, int index) {
 	// redundant but specified 
 	if (src->actualSize == 0) return ARRAY_LIST_EMPTY;
 
-	// shift the array!
-	for (int i = index + 1; i < src->actualSize; i++) {
-		(src->elements)[i - 1] = (src->elements)[i];
+	// shift the shorter side of the array - the elements before the index one step forward,
+	// or the elements after the index one step back
+	if (index < src->actualSize / 2) {
+		for (int i = index; i > 0; i--) {
+			(src->elements)[arrayListGetPosition(src, i)] = (src->elements)[arrayListGetPosition(src, i - 1)];
+		}
+
+		src->head = arrayListGetPosition(src, 1);
+	}
+	else {
+		for (int i = index + 1; i < src->actualSize; i++) {
+			(src->elements)[arrayListGetPosition(src, i - 1)] = (src->elements)[arrayListGetPosition(src, i)];
+		}
 	}
 
 	(src->actualSize)--;
@@ -154,7 +185,7 @@ HistoryElement arrayListGetAt(ArrayList* src, int index) {
 		return (HistoryElement) { .oldSquare = { -1, -1 } };
 	}
 
-	return src->elements[index];
+	return src->elements[arrayListGetPosition(src, index)];
 }
 
 HistoryElement arrayListGetFirst(ArrayList* src) {
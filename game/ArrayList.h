@@ -13,22 +13,28 @@
 * is specified at the creation. The container supports typical list
 * functionalities with the addition of random access as in arrays.
 * Upon insertion, if the maximum capacity is reached then an error message is
-* returned and the list is not affected. A summary of the supported functions
+* returned and the list is not affected.
+* The elements are kept in a ring buffer, so adding or removing an element at
+* either end of the list takes constant time, and in the middle of the list only
+* the elements on the shorter side of the index are shifted. A summary of the supported functions
 * is given below:
 *
 * arrayListCreate       - Creates an empty array list with a specified
 *                           max capacity.
+* arrayListCopy         - Creates an exact copy of an array list.
+* arrayListCopyInto     - Copies the elements of an array list into an existing
+*                           array list.
 * arrayListDestroy      - Frees all memory resources associated with an array
 *                           list.
 * arrayListAddAt        - Inserts an element at a specified index, elements
 *                           will be shifted to make place.
 * arrayListAddFirst     - Inserts an element at the beginning of the array
-*                           list, elements will be shifted to make place.
+*                           list.
 * arrayListAddLast      - Inserts an element at the end of the array list.
 * arrayListRemoveAt     - Removes an element at the specified index, elements
 *                           elements will be shifted as a result.
 * arrayListRemoveFirst  - Removes an element from the beginning of the array
-*                           list, elements will be shifted as a result.
+*                           list.
 * arrayListRemoveLast   - Removes an element from the end of the array list
 * arrayListGetAt        - Accesses the element at the specified index.
 * arrayListGetFirst     - Accesses the first element of the array list.
@@ -54,6 +60,7 @@ typedef struct array_list_t {
 	HistoryElement * elements;
 	int actualSize;
 	int maxSize;
+	int head; // the position of the first element in the elements array, the list wraps around its end
 } ArrayList;
 
 /**
@@ -75,6 +82,29 @@ typedef enum array_list_message_t {
 */
 ArrayList* arrayListCreate(int maxSize);
 
+/**
+*  Creates an exact copy of the source array list, with the same maximum capacity
+*  and the same elements.
+*  @param src - the source array list
+*  @return
+*  NULL, if an allocation error occurred or src is NULL.
+*  A new array list otherwise.
+*/
+ArrayList* arrayListCopy(ArrayList* src);
+
+/**
+*  Copies the elements of the source array list into the destination array list,
+*  replacing its elements. The capacity of the destination is not changed, and no
+*  memory is allocated.
+*  @param src - the source array list
+*  @param dst - the destination array list
+*  @return
+*  ARRAY_LIST_INVALID_ARGUMENT - if src or dst are NULL.
+*  ARRAY_LIST_FULL - if the elements of src don't fit in the capacity of dst (dst is not affected).
+*  ARRAY_LIST_SUCCESS - otherwise.
+*/
+ARRAY_LIST_MESSAGE arrayListCopyInto(ArrayList* src, ArrayList* dst);
+
 /**
 * Frees all memory resources associated with the source array list. If the
 * source array is NULL, then the function does nothing.
@@ -84,7 +114,8 @@ void arrayListDestroy(ArrayList* src);
 
 /**
 * Inserts element at a specified index. The elements residing at and after the
-* specified index will be shifted to make place for the new element. If the
+* specified index (or the elements before it, if there are fewer of them) will be
+* shifted to make place for the new element. If the
 * array list reached its maximum capacity and error message is returned and
 * the source list is not affected
 * @param src   - the source array list
@@ -99,8 +130,7 @@ void arrayListDestroy(ArrayList* src);
 ARRAY_LIST_MESSAGE arrayListAddAt(ArrayList* src, HistoryElement elem, int index);
 
 /**
-* Inserts element at a the beginning of the source element. The elements
-* will be shifted to make place for the new element. If the
+* Inserts element at a the beginning of the source element, in constant time. If the
 * array list reached its maximum capacity and error message is returned and
 * the source list is not affected
 * @param src   - the source array list
@@ -127,7 +157,8 @@ ARRAY_LIST_MESSAGE arrayListAddLast(ArrayList* src, HistoryElement elem);
 
 /**
 * Removes an element from a specified index. The elements residing after the
-* specified index will be shifted to make to keep the list continuous. If the
+* specified index (or the elements before it, if there are fewer of them) will be
+* shifted to make to keep the list continuous. If the
 * array list is empty then an error message is returned and the source list
 * is not affected
 * @param src   - The source array list
@@ -141,8 +172,7 @@ ARRAY_LIST_MESSAGE arrayListAddLast(ArrayList* src, HistoryElement elem);
 ARRAY_LIST_MESSAGE arrayListRemoveAt(ArrayList* src, int index);
 
 /**
-* Removes an element from a the beginning of the list.
-* The elements will be shifted to make to keep the list continuous. If the
+* Removes an element from a the beginning of the list, in constant time. If the
 * array list is empty then an error message is returned and the source list
 * is not affected
 * @param src   - The source array list
@@ -155,8 +185,7 @@ ARRAY_LIST_MESSAGE arrayListRemoveAt(ArrayList* src, int index);
 ARRAY_LIST_MESSAGE arrayListRemoveFirst(ArrayList* src);
 
 /**
-* Removes an element from a the end of the list.
-* The elements will be shifted to make to keep the list continuous. If the
+* Removes an element from a the end of the list, in constant time. If the
 * array list is empty then an error message is returned and the source list
 * is not affected
 * @param src   - The source array list
@@ -0,0 +1,99 @@
+#include "Bitboard.h"
+
+int bitboardLeastSignificantIndex(Bitboard b) {
+#if defined(__GNUC__)
+	return __builtin_ctzll(b);
+#else
+	int index = 0;
+
+	while (!(b & 1)) {
+		b >>= 1;
+		index++;
+	}
+
+	return index;
+#endif
+}
+
+int bitboardPopLeastSignificantIndex(Bitboard * b) {
+	int index = bitboardLeastSignificantIndex(*b);
+
+	*b &= *b - 1; // clears the least significant bit
+
+	return index;
+}
+
+int bitboardCount(Bitboard b) {
+#if defined(__GNUC__)
+	return __builtin_popcountll(b);
+#else
+	int count = 0;
+
+	for (; b; b &= b - 1) count++;
+
+	return count;
+#endif
+}
+
+Bitboard bitboardKnightAttacks(Bitboard knights) {
+	Bitboard attacks = BITBOARD_EMPTY;
+
+	attacks |= (knights << 6) & ~(BITBOARD_COLUMN_G | BITBOARD_COLUMN_H); // 2 left, 1 up
+	attacks |= (knights << 15) & ~BITBOARD_COLUMN_H; // 1 left, 2 up
+	attacks |= (knights >> 10) & ~(BITBOARD_COLUMN_G | BITBOARD_COLUMN_H); // 2 left, 1 down
+	attacks |= (knights >> 17) & ~BITBOARD_COLUMN_H; // 1 left, 2 down
+	attacks |= (knights << 10) & ~(BITBOARD_COLUMN_A | BITBOARD_COLUMN_B); // 2 right, 1 up
+	attacks |= (knights << 17) & ~BITBOARD_COLUMN_A; // 1 right, 2 up
+	attacks |= (knights >> 6) & ~(BITBOARD_COLUMN_A | BITBOARD_COLUMN_B); // 2 right, 1 down
+	attacks |= (knights >> 15) & ~BITBOARD_COLUMN_A; // 1 right, 2 down
+
+	return attacks;
+}
+
+Bitboard bitboardKingAttacks(Bitboard kings) {
+	Bitboard attacks, sideways;
+
+	// left and right, and then the whole row up and down
+	sideways = ((kings << 1) & ~BITBOARD_COLUMN_A) | ((kings >> 1) & ~BITBOARD_COLUMN_H);
+	attacks = sideways | kings;
+	attacks |= (attacks << 8) | (attacks >> 8);
+
+	return attacks & ~kings;
+}
+
+Bitboard bitboardPawnAttacks(Bitboard pawns, bool isWhite) {
+	if (isWhite) return ((pawns << 9) & ~BITBOARD_COLUMN_A) | ((pawns << 7) & ~BITBOARD_COLUMN_H);
+
+	return ((pawns >> 7) & ~BITBOARD_COLUMN_A) | ((pawns >> 9) & ~BITBOARD_COLUMN_H);
+}
+
+/*
+Returns the squares on a single ray that starts from square (excluded). The ray stops on the
+first occupied square (included).
+A positive shift moves towards the last row, and mask removes the squares that wrapped around
+the board edge.
+*/
+static Bitboard bitboardRayAttacks(Bitboard square, Bitboard occupied, int shift, Bitboard mask) {
+	Bitboard attacks = BITBOARD_EMPTY;
+
+	do {
+		square = (shift > 0) ? (square << shift) & mask : (square >> -shift) & mask;
+		attacks |= square;
+	} while (square && !(square & occupied));
+
+	return attacks;
+}
+
+Bitboard bitboardBishopAttacks(Bitboard square, Bitboard occupied) {
+	return bitboardRayAttacks(square, occupied, 9, ~BITBOARD_COLUMN_A) | // right, forward diagonal
+		bitboardRayAttacks(square, occupied, 7, ~BITBOARD_COLUMN_H) | // left, forward diagonal
+		bitboardRayAttacks(square, occupied, -7, ~BITBOARD_COLUMN_A) | // right, backward diagonal
+		bitboardRayAttacks(square, occupied, -9, ~BITBOARD_COLUMN_H); // left, backward diagonal
+}
+
+Bitboard bitboardRookAttacks(Bitboard square, Bitboard occupied) {
+	return bitboardRayAttacks(square, occupied, 8, ~BITBOARD_EMPTY) | // forward
+		bitboardRayAttacks(square, occupied, -8, ~BITBOARD_EMPTY) | // backward
+		bitboardRayAttacks(square, occupied, 1, ~BITBOARD_COLUMN_A) | // right
+		bitboardRayAttacks(square, occupied, -1, ~BITBOARD_COLUMN_H); // left
+}
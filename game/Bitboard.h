@@ -0,0 +1,96 @@
+#ifndef BITBOARD_H_
+#define BITBOARD_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+Bitboard Summary:
+A bitboard is a 64-bit set of board squares. Bit number (row * 8 + col) is set iff the square
+<row, col> belongs to the set, so row 0 (the white first row) is held in the 8 least significant bits.
+
+This module contains only board-independent primitives (attack sets and bit iteration).
+The bitboards of a game are kept in the Game struct and are maintained by the Game module.
+*/
+
+typedef uint64_t Bitboard;
+
+#define BITBOARD_EMPTY ((Bitboard)0)
+#define BITBOARD_SQUARE_INDEX(row, col) ((row) * 8 + (col))
+#define BITBOARD_SQUARE(row, col) ((Bitboard)1 << BITBOARD_SQUARE_INDEX(row, col))
+#define BITBOARD_INDEX_ROW(index) ((index) / 8)
+#define BITBOARD_INDEX_COL(index) ((index) % 8)
+
+#define BITBOARD_COLUMN_A 0x0101010101010101ULL
+#define BITBOARD_COLUMN_B 0x0202020202020202ULL
+#define BITBOARD_COLUMN_G 0x4040404040404040ULL
+#define BITBOARD_COLUMN_H 0x8080808080808080ULL
+#define BITBOARD_COLUMN(col) (BITBOARD_COLUMN_A << (col))
+#define BITBOARD_ROW(row) ((Bitboard)0xFF << ((row) * 8))
+
+/*
+Piece types, used as an index to the per-piece bitboards.
+*/
+typedef enum bitboard_piece_type_e {
+	BitboardPawn,
+	BitboardKnight,
+	BitboardBishop,
+	BitboardRook,
+	BitboardQueen,
+	BitboardKing,
+	BitboardPieceTypesNumber
+} BitboardPieceType;
+
+/*
+Returns the index of the least significant set bit of b.
+Assumes b is not empty.
+*/
+int bitboardLeastSignificantIndex(Bitboard b);
+
+/*
+Returns the index of the least significant set bit of *b, and clears this bit.
+Assumes *b is not empty.
+@param b pointer to the bitboard
+@return the index of the removed square
+*/
+int bitboardPopLeastSignificantIndex(Bitboard * b);
+
+/*
+Returns the number of set bits (squares) in b.
+*/
+int bitboardCount(Bitboard b);
+
+/*
+Returns the squares attacked by the knights in the given set.
+*/
+Bitboard bitboardKnightAttacks(Bitboard knights);
+
+/*
+Returns the squares attacked by the kings in the given set.
+*/
+Bitboard bitboardKingAttacks(Bitboard kings);
+
+/*
+Returns the squares attacked (diagonally) by the pawns in the given set.
+@param pawns the pawns
+@param isWhite true iff the pawns are white pawns (i.e they move towards the last row)
+*/
+Bitboard bitboardPawnAttacks(Bitboard pawns, bool isWhite);
+
+/*
+Returns the squares attacked by a bishop in the given square. A ray stops at the first
+occupied square, and that square is included in the attacks.
+@param square a bitboard with exactly one bit set - the square of the piece
+@param occupied all the occupied squares on the board
+*/
+Bitboard bitboardBishopAttacks(Bitboard square, Bitboard occupied);
+
+/*
+Returns the squares attacked by a rook in the given square. A ray stops at the first
+occupied square, and that square is included in the attacks.
+@param square a bitboard with exactly one bit set - the square of the piece
+@param occupied all the occupied squares on the board
+*/
+Bitboard bitboardRookAttacks(Bitboard square, Bitboard occupied);
+
+#endif
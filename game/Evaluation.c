@@ -0,0 +1,186 @@
+#include "Evaluation.h"
+
+#define EVALUATION_MIDDLEGAME 0
+#define EVALUATION_ENDGAME 1
+
+/*
+The piece-square tables, indexed by [middlegame / endgame][piece type][square].
+Each table is written as seen by white, from the last row (row 7) down to the first row (row 0),
+so the first line of a table is the row that white pawns promote on.
+*/
+static const int evaluationTables[2][BitboardPieceTypesNumber][64] = {
+	{ // middlegame
+		{ // pawn
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			 50,  50,  50,  50,  50,  50,  50,  50,
+			 10,  10,  20,  30,  30,  20,  10,  10,
+			  5,   5,  10,  25,  25,  10,   5,   5,
+			  0,   0,   0,  20,  20,   0,   0,   0,
+			  5,  -5, -10,   0,   0, -10,  -5,   5,
+			  5,  10,  10, -20, -20,  10,  10,   5,
+			  0,   0,   0,   0,   0,   0,   0,   0
+		},
+		{ // knight
+			-50, -40, -30, -30, -30, -30, -40, -50,
+			-40, -20,   0,   0,   0,   0, -20, -40,
+			-30,   0,  10,  15,  15,  10,   0, -30,
+			-30,   5,  15,  20,  20,  15,   5, -30,
+			-30,   0,  15,  20,  20,  15,   0, -30,
+			-30,   5,  10,  15,  15,  10,   5, -30,
+			-40, -20,   0,   5,   5,   0, -20, -40,
+			-50, -40, -30, -30, -30, -30, -40, -50
+		},
+		{ // bishop
+			-20, -10, -10, -10, -10, -10, -10, -20,
+			-10,   0,   0,   0,   0,   0,   0, -10,
+			-10,   0,   5,  10,  10,   5,   0, -10,
+			-10,   5,   5,  10,  10,   5,   5, -10,
+			-10,   0,  10,  10,  10,  10,   0, -10,
+			-10,  10,  10,  10,  10,  10,  10, -10,
+			-10,   5,   0,   0,   0,   0,   5, -10,
+			-20, -10, -10, -10, -10, -10, -10, -20
+		},
+		{ // rook
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  5,  10,  10,  10,  10,  10,  10,   5,
+			 -5,   0,   0,   0,   0,   0,   0,  -5,
+			 -5,   0,   0,   0,   0,   0,   0,  -5,
+			 -5,   0,   0,   0,   0,   0,   0,  -5,
+			 -5,   0,   0,   0,   0,   0,   0,  -5,
+			 -5,   0,   0,   0,   0,   0,   0,  -5,
+			  0,   0,   0,   5,   5,   0,   0,   0
+		},
+		{ // queen
+			-20, -10, -10,  -5,  -5, -10, -10, -20,
+			-10,   0,   0,   0,   0,   0,   0, -10,
+			-10,   0,   5,   5,   5,   5,   0, -10,
+			 -5,   0,   5,   5,   5,   5,   0,  -5,
+			  0,   0,   5,   5,   5,   5,   0,  -5,
+			-10,   5,   5,   5,   5,   5,   0, -10,
+			-10,   0,   5,   0,   0,   0,   0, -10,
+			-20, -10, -10,  -5,  -5, -10, -10, -20
+		},
+		{ // king - stay behind the pawns
+			-30, -40, -40, -50, -50, -40, -40, -30,
+			-30, -40, -40, -50, -50, -40, -40, -30,
+			-30, -40, -40, -50, -50, -40, -40, -30,
+			-30, -40, -40, -50, -50, -40, -40, -30,
+			-20, -30, -30, -40, -40, -30, -30, -20,
+			-10, -20, -20, -20, -20, -20, -20, -10,
+			 20,  20,   0,   0,   0,   0,  20,  20,
+			 20,  30,  10,   0,   0,  10,  30,  20
+		}
+	},
+	{ // endgame
+		{ // pawn - advance
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			 80,  80,  80,  80,  80,  80,  80,  80,
+			 50,  50,  50,  50,  50,  50,  50,  50,
+			 30,  30,  30,  30,  30,  30,  30,  30,
+			 20,  20,  20,  20,  20,  20,  20,  20,
+			 10,  10,  10,  10,  10,  10,  10,  10,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0
+		},
+		{ // knight
+			-50, -40, -30, -30, -30, -30, -40, -50,
+			-40, -20,   0,   0,   0,   0, -20, -40,
+			-30,   0,  10,  15,  15,  10,   0, -30,
+			-30,   5,  15,  20,  20,  15,   5, -30,
+			-30,   0,  15,  20,  20,  15,   0, -30,
+			-30,   5,  10,  15,  15,  10,   5, -30,
+			-40, -20,   0,   5,   5,   0, -20, -40,
+			-50, -40, -30, -30, -30, -30, -40, -50
+		},
+		{ // bishop
+			-20, -10, -10, -10, -10, -10, -10, -20,
+			-10,   0,   0,   0,   0,   0,   0, -10,
+			-10,   0,   5,  10,  10,   5,   0, -10,
+			-10,   5,   5,  10,  10,   5,   5, -10,
+			-10,   0,  10,  10,  10,  10,   0, -10,
+			-10,  10,  10,  10,  10,  10,  10, -10,
+			-10,   5,   0,   0,   0,   0,   5, -10,
+			-20, -10, -10, -10, -10, -10, -10, -20
+		},
+		{ // rook
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			 10,  10,  10,  10,  10,  10,  10,  10,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0
+		},
+		{ // queen
+			-20, -10, -10,  -5,  -5, -10, -10, -20,
+			-10,   0,   0,   0,   0,   0,   0, -10,
+			-10,   0,   5,   5,   5,   5,   0, -10,
+			 -5,   0,   5,   5,   5,   5,   0,  -5,
+			 -5,   0,   5,   5,   5,   5,   0,  -5,
+			-10,   0,   5,   5,   5,   5,   0, -10,
+			-10,   0,   0,   0,   0,   0,   0, -10,
+			-20, -10, -10,  -5,  -5, -10, -10, -20
+		},
+		{ // king - go to the center
+			-50, -40, -30, -20, -20, -30, -40, -50,
+			-30, -20, -10,   0,   0, -10, -20, -30,
+			-30, -10,  20,  30,  30,  20, -10, -30,
+			-30, -10,  30,  40,  40,  30, -10, -30,
+			-30, -10,  30,  40,  40,  30, -10, -30,
+			-30, -10,  20,  30,  30,  20, -10, -30,
+			-30, -30,   0,   0,   0,   0, -30, -30,
+			-50, -30, -30, -30, -30, -30, -30, -50
+		}
+	}
+};
+
+// the phase weight of each piece type, indexed by BitboardPieceType
+static const int evaluationPhaseWeights[BitboardPieceTypesNumber] = { 0, 1, 1, 2, 4, 0 };
+
+// flips the row of a square index (row * 8 + col) and keeps its column
+#define EVALUATION_FLIP_ROW(squareIndex) ((squareIndex) ^ 56)
+
+/*
+Returns the index of the square in the tables. The two players see the board mirrored by the rows only
+(not by the columns), so a square of one player and the same square of the other player with its row flipped
+get the same value. The tables are written from the last row down, so the white squares (player 0) are
+flipped, while the black squares (which see the board from the other side) are used as they are.
+*/
+static int evaluationGetTableIndex(int player, int squareIndex) {
+	return player == 0 ? EVALUATION_FLIP_ROW(squareIndex) : squareIndex;
+}
+
+void evaluationClear(EvaluationState * state) {
+	for (int player = 0; player < 2; player++) {
+		state->middlegame[player] = 0;
+		state->endgame[player] = 0;
+	}
+
+	state->phase = 0;
+}
+
+void evaluationAddPiece(EvaluationState * state, int player, BitboardPieceType pieceType, int squareIndex) {
+	int index = evaluationGetTableIndex(player, squareIndex);
+
+	state->middlegame[player] += evaluationTables[EVALUATION_MIDDLEGAME][pieceType][index];
+	state->endgame[player] += evaluationTables[EVALUATION_ENDGAME][pieceType][index];
+	state->phase += evaluationPhaseWeights[pieceType];
+}
+
+void evaluationRemovePiece(EvaluationState * state, int player, BitboardPieceType pieceType, int squareIndex) {
+	int index = evaluationGetTableIndex(player, squareIndex);
+
+	state->middlegame[player] -= evaluationTables[EVALUATION_MIDDLEGAME][pieceType][index];
+	state->endgame[player] -= evaluationTables[EVALUATION_ENDGAME][pieceType][index];
+	state->phase -= evaluationPhaseWeights[pieceType];
+}
+
+int evaluationGetPositionalScore(EvaluationState * state, int player) {
+	int opponent = 1 - player;
+	int phase = state->phase < EVALUATION_MAX_PHASE ? state->phase : EVALUATION_MAX_PHASE;
+	int middlegame = state->middlegame[player] - state->middlegame[opponent];
+	int endgame = state->endgame[player] - state->endgame[opponent];
+
+	return (middlegame * phase + endgame * (EVALUATION_MAX_PHASE - phase)) / EVALUATION_MAX_PHASE;
+}
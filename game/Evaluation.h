@@ -0,0 +1,60 @@
+#ifndef EVALUATION_H_
+#define EVALUATION_H_
+
+#include "Bitboard.h"
+
+/*
+Evaluation Summary:
+Positional evaluation by piece-square tables. Every piece type has a middlegame table and an endgame
+table (compile-time constants) that give a bonus or a penalty for a piece on each square. The two
+scores are interpolated by the game phase, which is computed from the non-pawn material left on the
+board: with all the pieces it's the middlegame score, and with pawns and kings only it's the endgame score.
+
+The evaluation state holds the sums of the table values of all the pieces, so it can be updated
+incrementally when a piece is added or removed. It's kept in the Game struct by the Game module.
+Scores are in centipawns (a pawn is EVALUATION_PAWN_VALUE).
+*/
+
+#define EVALUATION_PAWN_VALUE 100
+#define EVALUATION_MAX_PHASE 24 // the phase of the initial position
+
+typedef struct evaluation_state_t {
+	int middlegame[2]; // the sum of the middlegame table values of each player, indexed by ChessPlayer
+	int endgame[2]; // the sum of the endgame table values of each player, indexed by ChessPlayer
+	int phase; // the phase weight of the pieces on the board (may exceed EVALUATION_MAX_PHASE)
+} EvaluationState;
+
+/*
+Resets the state to an empty board.
+@param state the evaluation state
+*/
+void evaluationClear(EvaluationState * state);
+
+/*
+Adds a piece to the state.
+@param state the evaluation state
+@param player the player that the piece belongs to (a ChessPlayer value)
+@param pieceType the piece type
+@param squareIndex the square index (row * 8 + col)
+*/
+void evaluationAddPiece(EvaluationState * state, int player, BitboardPieceType pieceType, int squareIndex);
+
+/*
+Removes a piece from the state. Assumes the piece has been added before.
+@param state the evaluation state
+@param player the player that the piece belongs to (a ChessPlayer value)
+@param pieceType the piece type
+@param squareIndex the square index (row * 8 + col)
+*/
+void evaluationRemovePiece(EvaluationState * state, int player, BitboardPieceType pieceType, int squareIndex);
+
+/*
+Returns the positional score (material excluded) from the point of view of the given player,
+tapered between the middlegame and the endgame scores by the phase.
+@param state the evaluation state
+@param player the player (a ChessPlayer value)
+@return the score in centipawns, positive if the position of the player is better
+*/
+int evaluationGetPositionalScore(EvaluationState * state, int player);
+
+#endif
@@ -1,5 +1,8 @@
 #include "Game.h"
 
+// the material values of the pieces, indexed by BitboardPieceType
+static const int gamePieceValues[BitboardPieceTypesNumber] = { 1, 3, 3, 5, 9, 100 };
+
 /*
 Sets the game board and the pieces to initial game state.
 Assumes gameBoard is not null.
@@ -18,6 +21,59 @@ static void setupInitialGameBoard(ChessBoard gameBoard) {
 	strncpy(gameBoard[BOARD_ROWS_NUMBER - 2], BOARD_BLACK_SECOND_ROW_INITIAL_PIECES, BOARD_COLUMNS_NUMBER);
 }
 
+/*
+Returns the bitboard piece type of the piece.
+Assumes piece is one of the valid pieces (in any case).
+*/
+static BitboardPieceType gameGetBitboardPieceType(char piece) {
+	switch (tolower(piece)) {
+	case PIECE_PAWN:
+		return BitboardPawn;
+	case PIECE_KNIGHT:
+		return BitboardKnight;
+	case PIECE_BISHOP:
+		return BitboardBishop;
+	case PIECE_ROOK:
+		return BitboardRook;
+	case PIECE_QUEEN:
+		return BitboardQueen;
+	}
+
+	return BitboardKing;
+}
+
+/*
+Adds the piece to the bitboards, the zobrist key, the material and the evaluation state if it's not there,
+or removes it if it is.
+Does nothing if piece is an empty cell.
+*/
+static void gameTogglePiece(Game * game, char piece, BoardSquare s) {
+	ChessPlayer player;
+	BitboardPieceType pieceType;
+	Bitboard square;
+
+	if (piece == BOARD_EMPTY_CELL) return;
+
+	player = islower(piece) ? White : Black;
+	pieceType = gameGetBitboardPieceType(piece);
+	square = BITBOARD_SQUARE(s.row, s.col);
+
+	if (game->bitboards.pieces[player][pieceType] & square) {
+		game->material[player] -= gamePieceValues[pieceType];
+		evaluationRemovePiece(&game->evaluation, player, pieceType, BITBOARD_SQUARE_INDEX(s.row, s.col));
+	}
+	else {
+		game->material[player] += gamePieceValues[pieceType];
+		evaluationAddPiece(&game->evaluation, player, pieceType, BITBOARD_SQUARE_INDEX(s.row, s.col));
+	}
+
+	game->bitboards.pieces[player][pieceType] ^= square;
+	game->bitboards.occupied[player] ^= square;
+	game->mailbox[MAILBOX_INDEX(s.row, s.col)] ^=
+		MAILBOX_PIECE(player == White ? MAILBOX_WHITE : MAILBOX_BLACK, pieceType);
+	game->zobristKey ^= zobristGetPieceKey(player, pieceType, BITBOARD_SQUARE_INDEX(s.row, s.col));
+}
+
 Game * gameCreate(int historySize) {
 	Game *game;
 
@@ -26,13 +82,16 @@ Game * gameCreate(int historySize) {
 	game = malloc(sizeof(Game));
 	if (game == NULL) return NULL;
 
+	zobristInitKeys();
+
 	game->currentPlayer = White;
-	game->isBlackKingChecked = false;
-	game->isWhiteKingChecked = false;
 
-	// set game board
+	// set game board and the state derived from it (bitboards, king squares and check status)
 	setupInitialGameBoard(game->gameBoard);
-	
+	gameSyncBoardState(game);
+
+	game->undoStackSize = 0;
+
 	game->history = arrayListCreate(historySize);
 
 	if (game->history == NULL) {
@@ -43,6 +102,41 @@ Game * gameCreate(int historySize) {
 	return game;
 }
 
+Game * gameClone(Game * game) {
+	Game * clone;
+
+	if (game == NULL) return NULL;
+
+	clone = malloc(sizeof(Game));
+	if (clone == NULL) return NULL;
+
+	// the whole state is stored by value, except the history
+	*clone = *game;
+
+	clone->history = arrayListCopy(game->history);
+
+	if (clone->history == NULL) {
+		free(clone);
+		return NULL;
+	}
+
+	return clone;
+}
+
+GAME_MESSAGE gameCopyInto(Game * src, Game * dst) {
+	ArrayList * dstHistory;
+
+	if (src == NULL || dst == NULL || src == dst) return GAME_INVALID_ARGUMENT;
+
+	dstHistory = dst->history;
+	if (arrayListCopyInto(src->history, dstHistory) != ARRAY_LIST_SUCCESS) return GAME_INVALID_ARGUMENT;
+
+	*dst = *src;
+	dst->history = dstHistory;
+
+	return GAME_SUCCESS;
+}
+
 void gameDestroy(Game * game) {
 	if (game == NULL) return;
 
@@ -83,161 +177,153 @@ GAME_MESSAGE gamePrintBoard(Game * game) {
 	return GAME_SUCCESS;
 }
 
+/*
+Returns true iff the piece belongs to the given player. Returns false for an empty cell.
+*/
+static bool gameIsPieceOfPlayer(char piece, ChessPlayer player) {
+	if (player == White) return islower(piece);
+
+	return isupper(piece);
+}
+
+/*
+Returns the player that the piece belongs to.
+Assumes piece is not an empty cell.
+*/
+static ChessPlayer gameGetPieceOwner(char piece) {
+	return islower(piece) ? White : Black;
+}
+
+/*
+Returns the opponent of the given player.
+*/
+static ChessPlayer gameGetOpponent(ChessPlayer player) {
+	return (player == White) ? Black : White;
+}
+
 /*
 Gets a game board and a PAWN square coordinates, and sets the movesBoard matrix 
 with all the possible moves for the pawn.
 Assumes all arguments are valid, and movesBoard contains only false.
 */
-static void getWhitePawnLegalMoves(ChessBoard gameBoard,
-	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s) {
+static void getPawnLegalMoves(ChessBoard gameBoard,
+	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s, ChessPlayer player) {
 	
 	int row, col;
+	int direction = (player == White) ? 1 : -1;
+	int initialRow = (player == White) ? 1 : BOARD_ROWS_NUMBER - 2;
+	ChessPlayer opponent = gameGetOpponent(player);
 
 	// one step forward
-	row = s.row + 1, col = s.col;
-	if (row < BOARD_ROWS_NUMBER && gameBoard[row][col] == BOARD_EMPTY_CELL) {
+	row = s.row + direction, col = s.col;
+	if (row >= 0 && row < BOARD_ROWS_NUMBER && gameBoard[row][col] == BOARD_EMPTY_CELL) {
 		movesBoard[row][col] = true;
 
 		// if the pawn is in the initial place - two steps forward
-		row = s.row + 2;
-		if (s.row == 1 && gameBoard[row][col] == BOARD_EMPTY_CELL) {
+		row = s.row + 2 * direction;
+		if (s.row == initialRow && gameBoard[row][col] == BOARD_EMPTY_CELL) {
 			movesBoard[row][col] = true;
 		}
 	}
 
 	// capture - diagonal right
-	row = s.row + 1, col = s.col + 1;
-	if (row < BOARD_ROWS_NUMBER && col < BOARD_COLUMNS_NUMBER &&
-		isupper(gameBoard[row][col])) {
+	row = s.row + direction, col = s.col + 1;
+	if (row >= 0 && row < BOARD_ROWS_NUMBER && col < BOARD_COLUMNS_NUMBER &&
+		gameIsPieceOfPlayer(gameBoard[row][col], opponent)) {
 		movesBoard[row][col] = true;
 	}
 
 	// capture - diagonal left
-	row = s.row + 1, col = s.col - 1;
-	if (row < BOARD_ROWS_NUMBER && col >= 0 && isupper(gameBoard[row][col])) {
+	row = s.row + direction, col = s.col - 1;
+	if (row >= 0 && row < BOARD_ROWS_NUMBER && col >= 0 &&
+		gameIsPieceOfPlayer(gameBoard[row][col], opponent)) {
 		movesBoard[row][col] = true;
 	}
 }
 
 /*
-Gets a game board and a BISHOP square coordinates, and sets the movesBoard matrix
-with all the possible moves for the pawn.
-Assumes all arguments are valid, and movesBoard contains only false.
+Sets the movesBoard matrix with the moves along a single ray, that starts next to square s
+and advances by (rowStep, colStep). The ray stops at the first piece, which is included only
+if it's an opponent piece.
+Assumes all arguments are valid.
 */
-static void getWhiteBishopLegalMoves(ChessBoard gameBoard,
-	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s) {
+static void getRayLegalMoves(ChessBoard gameBoard,
+	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s, ChessPlayer player,
+	int rowStep, int colStep) {
 
 	int row, col;
 
-	// right, forward diagonal
-	for (row = s.row + 1, col = s.col + 1; row < BOARD_ROWS_NUMBER && col < BOARD_COLUMNS_NUMBER; row++, col++) {
-		if (gameBoard[row][col] == BOARD_EMPTY_CELL) movesBoard[row][col] = true;
-
-		else {
-			if (isupper(gameBoard[row][col])) movesBoard[row][col] = true;
+	for (row = s.row + rowStep, col = s.col + colStep;
+		row >= 0 && row < BOARD_ROWS_NUMBER && col >= 0 && col < BOARD_COLUMNS_NUMBER;
+		row += rowStep, col += colStep) {
 
-			break;
-		}
-	}
-
-	// left, forward diagonal
-	for (row = s.row + 1, col = s.col - 1; row < BOARD_ROWS_NUMBER && col >= 0; row++, col--) {
 		if (gameBoard[row][col] == BOARD_EMPTY_CELL) movesBoard[row][col] = true;
 
 		else {
-			if (isupper(gameBoard[row][col])) movesBoard[row][col] = true;
+			if (!gameIsPieceOfPlayer(gameBoard[row][col], player)) movesBoard[row][col] = true;
 
 			break;
 		}
 	}
+}
 
-	// right, backward diagonal
-	for (row = s.row - 1, col = s.col + 1; row >= 0 && col < BOARD_COLUMNS_NUMBER; row--, col++) {
-		if (gameBoard[row][col] == BOARD_EMPTY_CELL) movesBoard[row][col] = true;
-
-		else {
-			if (isupper(gameBoard[row][col])) movesBoard[row][col] = true;
-
-			break;
-		}
-	}
-
-	// left, backward diagonal
-	for (row = s.row - 1, col = s.col - 1; row >= 0 && col >= 0; row--, col--) {
-		if (gameBoard[row][col] == BOARD_EMPTY_CELL) movesBoard[row][col] = true;
-
-		else {
-			if (isupper(gameBoard[row][col])) movesBoard[row][col] = true;
+/*
+Gets a game board and a BISHOP square coordinates, and sets the movesBoard matrix
+with all the possible moves for the bishop.
+Assumes all arguments are valid, and movesBoard contains only false.
+*/
+static void getBishopLegalMoves(ChessBoard gameBoard,
+	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s, ChessPlayer player) {
 
-			break;
-		}
-	}
+	getRayLegalMoves(gameBoard, movesBoard, s, player, 1, 1); // right, forward diagonal
+	getRayLegalMoves(gameBoard, movesBoard, s, player, 1, -1); // left, forward diagonal
+	getRayLegalMoves(gameBoard, movesBoard, s, player, -1, 1); // right, backward diagonal
+	getRayLegalMoves(gameBoard, movesBoard, s, player, -1, -1); // left, backward diagonal
 }
 
 /*
 Gets a game board and a ROOK square coordinates, and sets the movesBoard matrix
-with all the possible moves for the pawn.
+with all the possible moves for the rook.
 Assumes all arguments are valid, and movesBoard contains only false.
 */
-static void getWhiteRookLegalMoves(ChessBoard gameBoard,
-	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s) {
-
-	int row, col;
-
-	// forward
-	for (row = s.row + 1, col = s.col; row < BOARD_ROWS_NUMBER; row++) {
-		if (gameBoard[row][col] == BOARD_EMPTY_CELL) movesBoard[row][col] = true;
+static void getRookLegalMoves(ChessBoard gameBoard,
+	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s, ChessPlayer player) {
 
-		else {
-			if (isupper(gameBoard[row][col])) movesBoard[row][col] = true;
-
-			break;
-		}
-	}
-
-	// backward
-	for (row = s.row - 1, col = s.col; row >= 0; row--) {
-		if (gameBoard[row][col] == BOARD_EMPTY_CELL) movesBoard[row][col] = true;
-
-		else {
-			if (isupper(gameBoard[row][col])) movesBoard[row][col] = true;
-
-			break;
-		}
-	}
-
-	// right
-	for (row = s.row, col = s.col + 1; col < BOARD_COLUMNS_NUMBER; col++) {
-		if (gameBoard[row][col] == BOARD_EMPTY_CELL) movesBoard[row][col] = true;
+	getRayLegalMoves(gameBoard, movesBoard, s, player, 1, 0); // forward
+	getRayLegalMoves(gameBoard, movesBoard, s, player, -1, 0); // backward
+	getRayLegalMoves(gameBoard, movesBoard, s, player, 0, 1); // right
+	getRayLegalMoves(gameBoard, movesBoard, s, player, 0, -1); // left
+}
 
-		else {
-			if (isupper(gameBoard[row][col])) movesBoard[row][col] = true;
+/*
+Sets the movesBoard matrix with the potential moves that are on the board and are not
+occupied by a piece of the player.
+*/
+static void getStepLegalMoves(ChessBoard gameBoard,
+	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], ChessPlayer player,
+	BoardSquare potentialMoves[8]) {
 
-			break;
-		}
-	}
+	int row, col;
 
-	// left
-	for (row = s.row, col = s.col - 1; col >= 0; col--) {
-		if (gameBoard[row][col] == BOARD_EMPTY_CELL) movesBoard[row][col] = true;
+	for (int i = 0; i < 8; i++) {
+		row = potentialMoves[i].row, col = potentialMoves[i].col;
 
-		else {
-			if (isupper(gameBoard[row][col])) movesBoard[row][col] = true;
+		if (row >= 0 && row < BOARD_ROWS_NUMBER &&
+			col >= 0 && col < BOARD_COLUMNS_NUMBER &&
+			!gameIsPieceOfPlayer(gameBoard[row][col], player)) {
 
-			break;
+			movesBoard[row][col] = true;
 		}
 	}
 }
 
 /*
 Gets a game board and a KNIGHT square coordinates, and sets the movesBoard matrix
-with all the possible moves for the pawn.
+with all the possible moves for the knight.
 Assumes all arguments are valid, and movesBoard contains only false.
 */
-static void getWhiteKnightLegalMoves(ChessBoard gameBoard,
-	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s) {
-
-	int row, col;
+static void getKnightLegalMoves(ChessBoard gameBoard,
+	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s, ChessPlayer player) {
 
 	BoardSquare potentialMoves[8] = {
 		{ s.row + 1, s.col - 2 }, // 2 left, 1 up
@@ -250,39 +336,28 @@ static void getWhiteKnightLegalMoves(ChessBoard gameBoard,
 		{ s.row - 2, s.col + 1 }, // 1 right, 2 down
 	};
 
-	for (int i = 0; i < 8; i++) {
-		row = potentialMoves[i].row, col = potentialMoves[i].col;
-
-		if (row >= 0 && row < BOARD_ROWS_NUMBER && 
-			col >= 0 && col < BOARD_COLUMNS_NUMBER && 
-			!islower(gameBoard[row][col])) {
-
-			movesBoard[row][col] = true;
-		}
-	}
+	getStepLegalMoves(gameBoard, movesBoard, player, potentialMoves);
 }
 
 /*
 Gets a game board and a QUEEN square coordinates, and sets the movesBoard matrix
-with all the possible moves for the pawn.
+with all the possible moves for the queen.
 Assumes all arguments are valid, and movesBoard contains only false.
 */
-static void getWhiteQueenLegalMoves(ChessBoard gameBoard,
-	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s) {
+static void getQueenLegalMoves(ChessBoard gameBoard,
+	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s, ChessPlayer player) {
 
-	getWhiteBishopLegalMoves(gameBoard, movesBoard, s);
-	getWhiteRookLegalMoves(gameBoard, movesBoard, s);
+	getBishopLegalMoves(gameBoard, movesBoard, s, player);
+	getRookLegalMoves(gameBoard, movesBoard, s, player);
 }
 
 /*
 Gets a game board and a KING square coordinates, and sets the movesBoard matrix
-with all the possible moves for the pawn.
+with all the possible moves for the king.
 Assumes all arguments are valid, and movesBoard contains only false.
 */
-static void getWhiteKingLegalMoves(ChessBoard gameBoard,
-	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s) {
-
-	int row, col;
+static void getKingLegalMoves(ChessBoard gameBoard,
+	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s, ChessPlayer player) {
 
 	BoardSquare potentialMoves[8] = {
 		{ s.row + 1, s.col - 1 },
@@ -295,201 +370,649 @@ static void getWhiteKingLegalMoves(ChessBoard gameBoard,
 		{ s.row, s.col + 1 },
 	};
 
-	for (int i = 0; i < 8; i++) {
-		row = potentialMoves[i].row, col = potentialMoves[i].col;
+	getStepLegalMoves(gameBoard, movesBoard, player, potentialMoves);
+}
 
-		if (row >= 0 && row < BOARD_ROWS_NUMBER &&
-			col >= 0 && col < BOARD_COLUMNS_NUMBER &&
-			!islower(gameBoard[row][col])) {
+/*
+Returns { -1, -1 } if the king of the player is not on the game board.
+*/
+static BoardSquare getKingSquare(ChessBoard gameBoard, ChessPlayer player) {
+	BoardSquare s = { -1, -1 };
+	char king = (player == White) ? PIECE_KING : toupper(PIECE_KING);
 
-			movesBoard[row][col] = true;
+	for (int i = 0; i < BOARD_ROWS_NUMBER; i++) {
+		for (int j = 0; j < BOARD_COLUMNS_NUMBER; j++) {
+			if (gameBoard[i][j] == king) {
+				s.row = i;
+				s.col = j;
+				
+				return s;
+			}
 		}
 	}
+
+	return s;
 }
 
 /*
-Updates movesBoard with the legal moves of the piece in square s. Assumes all arguments are valid,
-movesBoard is initialized to false and the piece in s is a white piece.
+Returns the piece char of the given player (lowercase for white, uppercase for black).
+Assumes piece is one of the (lowercase) pieces definitions.
 */
-static void getWhitePieceLegalMoves(ChessBoard gameBoard,
-	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s) {
+static char gameGetPieceOfPlayer(char piece, ChessPlayer player) {
+	return (player == White) ? piece : (char)toupper(piece);
+}
 
-	switch (gameBoard[s.row][s.col]) {
+/*
+Returns true iff square <row, col> is on the board and contains one of the given pieces.
+*/
+static bool gameSquareContainsPiece(ChessBoard gameBoard, int row, int col, char piece, char otherPiece) {
+	if (row < 0 || row >= BOARD_ROWS_NUMBER || col < 0 || col >= BOARD_COLUMNS_NUMBER) return false;
+
+	return gameBoard[row][col] == piece || gameBoard[row][col] == otherPiece;
+}
+
+/*
+Returns true iff the first piece on the ray that starts next to square s and advances by
+(rowStep, colStep) is one of the given pieces.
+*/
+static bool gameRayEndsWithPiece(ChessBoard gameBoard, BoardSquare s, int rowStep, int colStep,
+	char piece, char otherPiece) {
+
+	int row, col;
+
+	for (row = s.row + rowStep, col = s.col + colStep;
+		row >= 0 && row < BOARD_ROWS_NUMBER && col >= 0 && col < BOARD_COLUMNS_NUMBER;
+		row += rowStep, col += colStep) {
+
+		if (gameBoard[row][col] != BOARD_EMPTY_CELL) {
+			return gameBoard[row][col] == piece || gameBoard[row][col] == otherPiece;
+		}
+	}
+
+	return false;
+}
+
+/*
+Checks if a piece of the attacker attacks the square. See gameIsSquareAttacked.
+*/
+static bool gameSquareHasAttacker(ChessBoard gameBoard, BoardSquare s, ChessPlayer attacker) {
+	static const int knightSteps[8][2] = { { 1, -2 }, { 2, -1 }, { -1, -2 }, { -2, -1 },
+		{ 1, 2 }, { 2, 1 }, { -1, 2 }, { -2, 1 } };
+	static const int kingSteps[8][2] = { { 1, -1 }, { 1, 0 }, { 1, 1 }, { -1, -1 },
+		{ -1, 0 }, { -1, 1 }, { 0, -1 }, { 0, 1 } };
+
+	char pawn = gameGetPieceOfPlayer(PIECE_PAWN, attacker);
+	char knight = gameGetPieceOfPlayer(PIECE_KNIGHT, attacker);
+	char bishop = gameGetPieceOfPlayer(PIECE_BISHOP, attacker);
+	char rook = gameGetPieceOfPlayer(PIECE_ROOK, attacker);
+	char queen = gameGetPieceOfPlayer(PIECE_QUEEN, attacker);
+	char king = gameGetPieceOfPlayer(PIECE_KING, attacker);
+
+	// pawns attack diagonally forward, so they are one row behind the square (from their point of view)
+	int pawnRow = (attacker == White) ? s.row - 1 : s.row + 1;
+
+	if (gameSquareContainsPiece(gameBoard, pawnRow, s.col - 1, pawn, pawn) ||
+		gameSquareContainsPiece(gameBoard, pawnRow, s.col + 1, pawn, pawn)) {
+		return true;
+	}
+
+	// knights and king
+	for (int i = 0; i < 8; i++) {
+		if (gameSquareContainsPiece(gameBoard, s.row + knightSteps[i][0], s.col + knightSteps[i][1], knight, knight) ||
+			gameSquareContainsPiece(gameBoard, s.row + kingSteps[i][0], s.col + kingSteps[i][1], king, king)) {
+			return true;
+		}
+	}
+
+	// sliding pieces - diagonals and then straight lines
+	return gameRayEndsWithPiece(gameBoard, s, 1, 1, bishop, queen) ||
+		gameRayEndsWithPiece(gameBoard, s, 1, -1, bishop, queen) ||
+		gameRayEndsWithPiece(gameBoard, s, -1, 1, bishop, queen) ||
+		gameRayEndsWithPiece(gameBoard, s, -1, -1, bishop, queen) ||
+		gameRayEndsWithPiece(gameBoard, s, 1, 0, rook, queen) ||
+		gameRayEndsWithPiece(gameBoard, s, -1, 0, rook, queen) ||
+		gameRayEndsWithPiece(gameBoard, s, 0, 1, rook, queen) ||
+		gameRayEndsWithPiece(gameBoard, s, 0, -1, rook, queen);
+}
+
+bool gameIsSquareAttacked(ChessBoard gameBoard, BoardSquare s, ChessPlayer attacker) {
+	bool isAttacked;
+
+	PROFILER_START(ProfilerGameIsSquareAttacked);
+	isAttacked = gameSquareHasAttacker(gameBoard, s, attacker);
+	PROFILER_STOP(ProfilerGameIsSquareAttacked);
+
+	return isAttacked;
+}
+
+bool gameBoardKingIsChecked(ChessBoard gameBoard, ChessPlayer player) {
+	BoardSquare kingSquare;
+	bool isChecked = false;
+
+	PROFILER_START(ProfilerGameBoardKingIsChecked);
+
+	kingSquare = getKingSquare(gameBoard, player);
+	if (kingSquare.row != -1) isChecked = gameIsSquareAttacked(gameBoard, kingSquare, gameGetOpponent(player));
+
+	PROFILER_STOP(ProfilerGameBoardKingIsChecked);
+
+	return isChecked;
+}
+
+void gameGetLegalMoves(ChessBoard gameBoard, bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s) {
+	ChessPlayer player = gameGetPieceOwner(gameBoard[s.row][s.col]);
+
+	PROFILER_START(ProfilerGameGetLegalMoves);
+
+	switch (tolower(gameBoard[s.row][s.col])) {
 	case PIECE_PAWN:
-		getWhitePawnLegalMoves(gameBoard, movesBoard, s);
+		getPawnLegalMoves(gameBoard, movesBoard, s, player);
 		break;
 	case PIECE_BISHOP:
-		getWhiteBishopLegalMoves(gameBoard, movesBoard, s);
+		getBishopLegalMoves(gameBoard, movesBoard, s, player);
 		break;
 	case PIECE_ROOK:
-		getWhiteRookLegalMoves(gameBoard, movesBoard, s);
+		getRookLegalMoves(gameBoard, movesBoard, s, player);
 		break;
 	case PIECE_KNIGHT:
-		getWhiteKnightLegalMoves(gameBoard, movesBoard, s);
+		getKnightLegalMoves(gameBoard, movesBoard, s, player);
 		break;
 	case PIECE_QUEEN:
-		getWhiteQueenLegalMoves(gameBoard, movesBoard, s);
+		getQueenLegalMoves(gameBoard, movesBoard, s, player);
 		break;
 	case PIECE_KING:
-		getWhiteKingLegalMoves(gameBoard, movesBoard, s);
+		getKingLegalMoves(gameBoard, movesBoard, s, player);
 		break;
 	}
+
+	PROFILER_STOP(ProfilerGameGetLegalMoves);
 }
 
 /*
-If c is non-letter, returns c.
+Returns the moves of a piece of the given type and player in the given square, according to the bitboards.
+Doesn't check threats.
 */
-static char changeCaseOfChar(char c) {
-	if (isupper(c)) return tolower(c);
-	if (islower(c)) return toupper(c);
+static Bitboard gameBitboardGetPieceMoves(GameBitboards * bitboards, BitboardPieceType pieceType,
+	ChessPlayer player, Bitboard square) {
+
+	Bitboard own = bitboards->occupied[player];
+	Bitboard enemy = bitboards->occupied[gameGetOpponent(player)];
+	Bitboard empty = ~(own | enemy), moves;
+
+	switch (pieceType) {
+	case BitboardPawn:
+		// one step forward, and two steps forward if the pawn is in the initial place
+		if (player == White) {
+			moves = (square << BOARD_COLUMNS_NUMBER) & empty;
+			moves |= ((moves & BITBOARD_ROW(2)) << BOARD_COLUMNS_NUMBER) & empty;
+		}
+		else {
+			moves = (square >> BOARD_COLUMNS_NUMBER) & empty;
+			moves |= ((moves & BITBOARD_ROW(BOARD_ROWS_NUMBER - 3)) >> BOARD_COLUMNS_NUMBER) & empty;
+		}
+
+		// captures
+		return moves | (bitboardPawnAttacks(square, player == White) & enemy);
+	case BitboardKnight:
+		return bitboardKnightAttacks(square) & ~own;
+	case BitboardBishop:
+		return bitboardBishopAttacks(square, own | enemy) & ~own;
+	case BitboardRook:
+		return bitboardRookAttacks(square, own | enemy) & ~own;
+	case BitboardQueen:
+		return (bitboardBishopAttacks(square, own | enemy) | bitboardRookAttacks(square, own | enemy)) & ~own;
+	case BitboardKing:
+		return bitboardKingAttacks(square) & ~own;
+	default:
+		break;
+	}
 
-	return c;
+	return BITBOARD_EMPTY;
+}
+
+void gameBitboardGetLegalMoves(Game * game, bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s) {
+	char piece = game->gameBoard[s.row][s.col];
+	Bitboard moves = gameBitboardGetPieceMoves(&game->bitboards, gameGetBitboardPieceType(piece),
+		gameGetPieceOwner(piece), BITBOARD_SQUARE(s.row, s.col));
+	int index;
+
+	PROFILER_START(ProfilerGameBitboardGetLegalMoves);
+
+	while (moves) {
+		index = bitboardPopLeastSignificantIndex(&moves);
+		movesBoard[BITBOARD_INDEX_ROW(index)][BITBOARD_INDEX_COL(index)] = true;
+	}
+
+	PROFILER_STOP(ProfilerGameBitboardGetLegalMoves);
 }
 
 /*
-Does as the name implies. 180 degrees rotation.
-The purpose of this function is to enable the use of WHITE-piece functions on BLACK pieces.
+Returns the bitboard of the square with the given mailbox index.
 */
-static void rotateBoardAndSwitchColors(ChessBoard gameBoard) {
-	char temp;
+static Bitboard gameMailboxSquare(int index) {
+	return BITBOARD_SQUARE(MAILBOX_INDEX_ROW(index), MAILBOX_INDEX_COL(index));
+}
 
-	for (int i = 0; i < BOARD_ROWS_NUMBER / 2; i++) { // divided by 2 to prevent double swapping
-		for (int j = 0; j < BOARD_COLUMNS_NUMBER; j++) {
-			temp = changeCaseOfChar(gameBoard[i][j]);
-			gameBoard[i][j] = changeCaseOfChar(gameBoard[BOARD_ROWS_NUMBER - 1 - i][BOARD_COLUMNS_NUMBER - 1 - j]);
-			gameBoard[BOARD_ROWS_NUMBER - 1 - i][BOARD_COLUMNS_NUMBER - 1 - j] = temp;
+/*
+Returns the destinations of the piece on the square s, by stepping on the mailbox (threats are not checked).
+*/
+static Bitboard gameMailboxGetPieceMoves(const unsigned char * mailbox, BoardSquare s) {
+	static const int knightSteps[8] = MAILBOX_KNIGHT_STEPS;
+	static const int kingSteps[8] = MAILBOX_KING_STEPS;
+	int from = MAILBOX_INDEX(s.row, s.col), to, forward, firstStep = 0, lastStep = 8;
+	unsigned char own = MAILBOX_COLOR(mailbox[from]);
+	unsigned char blocked = own | MAILBOX_OFF_BOARD; // the squares that a piece of the player can't move to
+	Bitboard moves = BITBOARD_EMPTY;
+
+	switch (MAILBOX_PIECE_TYPE(mailbox[from])) {
+	case BitboardPawn:
+		forward = (own == MAILBOX_WHITE) ? MAILBOX_COLUMNS_NUMBER : -MAILBOX_COLUMNS_NUMBER;
+
+		// one step forward, and two steps forward if the pawn is in the initial place
+		if (mailbox[from + forward] == MAILBOX_EMPTY) {
+			moves |= gameMailboxSquare(from + forward);
+
+			if (s.row == ((own == MAILBOX_WHITE) ? 1 : BOARD_ROWS_NUMBER - 2) &&
+				mailbox[from + 2 * forward] == MAILBOX_EMPTY) {
+				moves |= gameMailboxSquare(from + 2 * forward);
+			}
 		}
+
+		// captures - an off-board square has no color
+		if (MAILBOX_COLOR(mailbox[from + forward + 1]) & ~own) moves |= gameMailboxSquare(from + forward + 1);
+		if (MAILBOX_COLOR(mailbox[from + forward - 1]) & ~own) moves |= gameMailboxSquare(from + forward - 1);
+		break;
+	case BitboardKnight:
+		for (int i = 0; i < 8; i++) {
+			if (!(mailbox[from + knightSteps[i]] & blocked)) moves |= gameMailboxSquare(from + knightSteps[i]);
+		}
+		break;
+	case BitboardKing:
+		for (int i = 0; i < 8; i++) {
+			if (!(mailbox[from + kingSteps[i]] & blocked)) moves |= gameMailboxSquare(from + kingSteps[i]);
+		}
+		break;
+	default:
+		// sliding pieces - the bishop moves along the diagonal steps, the rook along the straight steps
+		if (MAILBOX_PIECE_TYPE(mailbox[from]) == BitboardBishop) lastStep = MAILBOX_STRAIGHT_STEPS_FIRST;
+		if (MAILBOX_PIECE_TYPE(mailbox[from]) == BitboardRook) firstStep = MAILBOX_STRAIGHT_STEPS_FIRST;
+
+		for (int i = firstStep; i < lastStep; i++) {
+			for (to = from + kingSteps[i]; mailbox[to] == MAILBOX_EMPTY; to += kingSteps[i]) {
+				moves |= gameMailboxSquare(to);
+			}
+
+			if (!(mailbox[to] & blocked)) moves |= gameMailboxSquare(to);
+		}
+		break;
 	}
+
+	return moves;
+}
+
+void gameMailboxGetLegalMoves(Game * game, bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s) {
+	Bitboard moves;
+	int index;
+
+	PROFILER_START(ProfilerGameMailboxGetLegalMoves);
+
+	moves = gameMailboxGetPieceMoves(game->mailbox, s);
+
+	while (moves) {
+		index = bitboardPopLeastSignificantIndex(&moves);
+		movesBoard[BITBOARD_INDEX_ROW(index)][BITBOARD_INDEX_COL(index)] = true;
+	}
+
+	PROFILER_STOP(ProfilerGameMailboxGetLegalMoves);
 }
 
 /*
-180 degrees rotation for the moves board.
+Returns true iff the first piece on the ray that starts next to the square with the given mailbox index
+and advances by step is one of the given pieces.
 */
-static void rotateMovesBoard(bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER]) {
-	bool temp;
+static bool gameMailboxRayEndsWithPiece(const unsigned char * mailbox, int index, int step,
+	unsigned char piece, unsigned char otherPiece) {
+
+	do {
+		index += step;
+	} while (mailbox[index] == MAILBOX_EMPTY);
+
+	return mailbox[index] == piece || mailbox[index] == otherPiece;
+}
+
+/*
+Checks if a piece of the attacker attacks the square, on the mailbox. See gameMailboxIsSquareAttacked.
+*/
+static bool gameMailboxSquareHasAttacker(const unsigned char * mailbox, BoardSquare s, ChessPlayer attacker) {
+	static const int knightSteps[8] = MAILBOX_KNIGHT_STEPS;
+	static const int kingSteps[8] = MAILBOX_KING_STEPS;
+	int index = MAILBOX_INDEX(s.row, s.col);
+	unsigned char color = (attacker == White) ? MAILBOX_WHITE : MAILBOX_BLACK;
+	unsigned char pawn = MAILBOX_PIECE(color, BitboardPawn), knight = MAILBOX_PIECE(color, BitboardKnight);
+	unsigned char bishop = MAILBOX_PIECE(color, BitboardBishop), rook = MAILBOX_PIECE(color, BitboardRook);
+	unsigned char queen = MAILBOX_PIECE(color, BitboardQueen), king = MAILBOX_PIECE(color, BitboardKing);
+
+	// pawns attack diagonally forward, so they are one row behind the square (from their point of view)
+	int pawnIndex = index + ((attacker == White) ? -MAILBOX_COLUMNS_NUMBER : MAILBOX_COLUMNS_NUMBER);
+
+	if (mailbox[pawnIndex - 1] == pawn || mailbox[pawnIndex + 1] == pawn) return true;
+
+	// knights and king
+	for (int i = 0; i < 8; i++) {
+		if (mailbox[index + knightSteps[i]] == knight || mailbox[index + kingSteps[i]] == king) return true;
+	}
+
+	// sliding pieces - diagonals and then straight lines
+	for (int i = MAILBOX_DIAGONAL_STEPS_FIRST; i < MAILBOX_STRAIGHT_STEPS_FIRST; i++) {
+		if (gameMailboxRayEndsWithPiece(mailbox, index, kingSteps[i], bishop, queen)) return true;
+	}
+
+	for (int i = MAILBOX_STRAIGHT_STEPS_FIRST; i < 8; i++) {
+		if (gameMailboxRayEndsWithPiece(mailbox, index, kingSteps[i], rook, queen)) return true;
+	}
+
+	return false;
+}
+
+bool gameMailboxIsSquareAttacked(Game * game, BoardSquare s, ChessPlayer attacker) {
+	bool isAttacked;
+
+	PROFILER_START(ProfilerGameMailboxIsSquareAttacked);
+	isAttacked = gameMailboxSquareHasAttacker(game->mailbox, s, attacker);
+	PROFILER_STOP(ProfilerGameMailboxIsSquareAttacked);
+
+	return isAttacked;
+}
+
+void gameChangePlayer(Game * game) {
+	if (game->currentPlayer == White) game->currentPlayer = Black;
+	else game->currentPlayer = White;
+
+	game->zobristKey ^= zobristGetSideKey();
+}
+
+ZobristKey gameComputeZobristKey(Game * game) {
+	ZobristKey key = 0;
+	char piece;
+
+	for (int i = 0; i < BOARD_ROWS_NUMBER; i++) {
+		for (int j = 0; j < BOARD_COLUMNS_NUMBER; j++) {
+			piece = game->gameBoard[i][j];
+
+			if (piece != BOARD_EMPTY_CELL) {
+				key ^= zobristGetPieceKey(gameGetPieceOwner(piece), gameGetBitboardPieceType(piece),
+					BITBOARD_SQUARE_INDEX(i, j));
+			}
+		}
+	}
+
+	if (game->currentPlayer == Black) key ^= zobristGetSideKey();
+
+	return key;
+}
+
+int gameGetPieceValue(char piece) {
+	return gamePieceValues[gameGetBitboardPieceType(piece)];
+}
 
-	for (int i = 0; i < BOARD_ROWS_NUMBER / 2; i++) { // divided by 2 to prevent double swapping
+int gameComputeMaterial(Game * game, ChessPlayer player) {
+	int material = 0;
+
+	for (int i = 0; i < BOARD_ROWS_NUMBER; i++) {
 		for (int j = 0; j < BOARD_COLUMNS_NUMBER; j++) {
-			temp = movesBoard[i][j];
-			movesBoard[i][j] = movesBoard[BOARD_ROWS_NUMBER - 1 - i][BOARD_COLUMNS_NUMBER - 1 - j];
-			movesBoard[BOARD_ROWS_NUMBER - 1 - i][BOARD_COLUMNS_NUMBER - 1 - j] = temp;
+			if (gameIsPieceOfPlayer(game->gameBoard[i][j], player)) {
+				material += gameGetPieceValue(game->gameBoard[i][j]);
+			}
 		}
 	}
+
+	return material;
 }
 
+#ifdef GAME_DEBUG
 /*
-Returns { -1, -1 } if the black king is not on the game board.
+Returns true iff the incremental evaluation state of the game is equal to the state that is
+computed from scratch.
 */
-static BoardSquare getBlackKingSquare(ChessBoard gameBoard) {
-	BoardSquare s = { -1, -1 };
+static bool gameIsEvaluationStateSynced(Game * game) {
+	EvaluationState state;
+	char piece;
+
+	evaluationClear(&state);
 
-	for (int i = BOARD_ROWS_NUMBER - 1; i >= 0; i--) { // starts from the end - optimization
+	for (int i = 0; i < BOARD_ROWS_NUMBER; i++) {
 		for (int j = 0; j < BOARD_COLUMNS_NUMBER; j++) {
-			if (gameBoard[i][j] == toupper(PIECE_KING)) {
-				s.row = i;
-				s.col = j;
-				
-				return s;
+			piece = game->gameBoard[i][j];
+
+			if (piece != BOARD_EMPTY_CELL) {
+				evaluationAddPiece(&state, gameGetPieceOwner(piece), gameGetBitboardPieceType(piece),
+					BITBOARD_SQUARE_INDEX(i, j));
 			}
 		}
 	}
 
-	return s;
+	return memcmp(&state, &game->evaluation, sizeof(EvaluationState)) == 0;
 }
 
 /*
-Checks if the BLACK king is in CHECK state. 
+Returns true iff the mailbox of the game holds the pieces of the game board.
 */
-static bool checkBlackKingCheckState(ChessBoard gameBoard) {
-	BoardSquare kingSquare = getBlackKingSquare(gameBoard);
-	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER] = { {false} };
+static bool gameIsMailboxSynced(Game * game) {
+	char piece;
+	unsigned char expected;
 
 	for (int i = 0; i < BOARD_ROWS_NUMBER; i++) {
 		for (int j = 0; j < BOARD_COLUMNS_NUMBER; j++) {
-			if (islower(gameBoard[i][j])) {
-				gameGetLegalMoves(gameBoard, movesBoard, (BoardSquare) { i, j });
-				if (movesBoard[kingSquare.row][kingSquare.col]) return true;
-			}
+			piece = game->gameBoard[i][j];
+			expected = (piece == BOARD_EMPTY_CELL) ? MAILBOX_EMPTY : MAILBOX_PIECE(islower(piece) ?
+				MAILBOX_WHITE : MAILBOX_BLACK, gameGetBitboardPieceType(piece));
+
+			if (game->mailbox[MAILBOX_INDEX(i, j)] != expected) return false;
 		}
 	}
-	
-	return false;
-}
 
-bool gameBoardKingIsChecked(ChessBoard gameBoard, ChessPlayer player) {
-	bool retValue;
+	return true;
+}
+#endif
 
-	if (player == Black) return checkBlackKingCheckState(gameBoard);
+/*
+Checks if the king of the player is in check state, starting from the tracked king square.
+*/
+static bool gameIsKingChecked(Game * game, ChessPlayer player) {
+	BoardSquare kingSquare = game->kingSquares[player];
+	bool isChecked = false;
+
+	PROFILER_START(ProfilerGameIsKingChecked);
+
+	if (kingSquare.row != -1) {
+#ifdef GAME_MAILBOX
+		isChecked = gameMailboxIsSquareAttacked(game, kingSquare, gameGetOpponent(player));
+#else
+		isChecked = gameIsSquareAttacked(game->gameBoard, kingSquare, gameGetOpponent(player));
+#endif
+
+#ifdef GAME_DEBUG
+		assert(isChecked == gameIsSquareAttacked(game->gameBoard, kingSquare, gameGetOpponent(player)));
+		assert(isChecked == gameMailboxIsSquareAttacked(game, kingSquare, gameGetOpponent(player)));
+#endif
+	}
 
-	rotateBoardAndSwitchColors(gameBoard);
-	retValue = checkBlackKingCheckState(gameBoard);
-	rotateBoardAndSwitchColors(gameBoard);
+	PROFILER_STOP(ProfilerGameIsKingChecked);
 
-	return retValue;
+	return isChecked;
 }
 
-void gameGetLegalMoves(ChessBoard gameBoard, bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s) {
+void gameSyncBoardState(Game * game) {
+	memset(&game->bitboards, 0, sizeof(GameBitboards));
 
-	bool isWhitePiece = islower(gameBoard[s.row][s.col]);
-	
-	if (!isWhitePiece) {
-		rotateBoardAndSwitchColors(gameBoard);
-		s.row = BOARD_ROWS_NUMBER - 1 - s.row;
-		s.col = BOARD_COLUMNS_NUMBER - 1 - s.col;
+	// the padding is off the board, and the board is emptied to be filled by the pieces
+	memset(game->mailbox, MAILBOX_OFF_BOARD, MAILBOX_SIZE);
+	for (int i = 0; i < BOARD_ROWS_NUMBER; i++) {
+		for (int j = 0; j < BOARD_COLUMNS_NUMBER; j++) game->mailbox[MAILBOX_INDEX(i, j)] = MAILBOX_EMPTY;
 	}
 
-	getWhitePieceLegalMoves(gameBoard, movesBoard, s);
+	game->material[White] = 0;
+	game->material[Black] = 0;
+	evaluationClear(&game->evaluation);
 
-	if (!isWhitePiece) {
-		rotateBoardAndSwitchColors(gameBoard);
-		rotateMovesBoard(movesBoard);
+	for (int i = 0; i < BOARD_ROWS_NUMBER; i++) {
+		for (int j = 0; j < BOARD_COLUMNS_NUMBER; j++) {
+			gameTogglePiece(game, game->gameBoard[i][j], (BoardSquare) { i, j });
+		}
 	}
-}
 
-void gameChangePlayer(Game * game) {
-	if (game->currentPlayer == White) game->currentPlayer = Black;
-	else game->currentPlayer = White;
+	game->zobristKey = gameComputeZobristKey(game);
+
+	game->kingSquares[White] = getKingSquare(game->gameBoard, White);
+	game->kingSquares[Black] = getKingSquare(game->gameBoard, Black);
+
+	game->isWhiteKingChecked = gameIsKingChecked(game, White);
+	game->isBlackKingChecked = gameIsKingChecked(game, Black);
 }
 
-void gameForceSetMove(Game * game, BoardSquare from, BoardSquare to) {	
-	HistoryElement histElement = { from, to, game->gameBoard[to.row][to.col],
-		game->isWhiteKingChecked, game->isBlackKingChecked };
+/*
+Packs a move between two squares, without flags.
+*/
+static GameMove gameMoveCreate(BoardSquare from, BoardSquare to) {
+	return GAME_MOVE_CREATE(BITBOARD_SQUARE_INDEX(from.row, from.col), BITBOARD_SQUARE_INDEX(to.row, to.col), 0);
+}
 
-	// add to history
-	arrayListAddLast(game->history, histElement);
+/*
+Moves the piece from the source square to the destination square (capturing the piece on it, if any),
+and updates the state that is derived from the board, the current player and the check status.
+The caller saves what is needed to undo the move.
+*/
+static void gameApplyMove(Game * game, BoardSquare from, BoardSquare to) {
+	// update bitboards - remove the captured piece (if any) and move the piece
+	gameTogglePiece(game, game->gameBoard[to.row][to.col], to);
+	gameTogglePiece(game, game->gameBoard[from.row][from.col], from);
+	gameTogglePiece(game, game->gameBoard[from.row][from.col], to);
 
 	// move!
 	game->gameBoard[to.row][to.col] = game->gameBoard[from.row][from.col];
 	game->gameBoard[from.row][from.col] = BOARD_EMPTY_CELL;
 
+	// update king square
+	if (tolower(game->gameBoard[to.row][to.col]) == PIECE_KING) {
+		game->kingSquares[gameGetPieceOwner(game->gameBoard[to.row][to.col])] = to;
+	}
+
 	// change player
 	gameChangePlayer(game);
 
 	// update check status
-	game->isBlackKingChecked = gameBoardKingIsChecked(game->gameBoard, Black);
-	game->isWhiteKingChecked = gameBoardKingIsChecked(game->gameBoard, White);
+	game->isBlackKingChecked = gameIsKingChecked(game, Black);
+	game->isWhiteKingChecked = gameIsKingChecked(game, White);
+
+#ifdef GAME_DEBUG
+	assert(game->zobristKey == gameComputeZobristKey(game));
+	assert(game->material[White] == gameComputeMaterial(game, White));
+	assert(game->material[Black] == gameComputeMaterial(game, Black));
+	assert(gameIsEvaluationStateSynced(game));
+	assert(gameIsMailboxSynced(game));
+#endif
 }
 
 /*
-This is a PRIVATE method that is used to undo a move without any checks.
-THIS FUNCTION SHOULD BE WRAPPED BEFORE USING IN GAME.
+Reverts a move that was applied by gameApplyMove: moves the piece back, restores the captured piece
+and the check status, and changes the player back.
 */
-static void gameForceUndoPrevMove(Game * game) {
-	HistoryElement histElement = arrayListGetLast(game->history);
-	arrayListRemoveLast(game->history);
+static void gameRevertMove(Game * game, BoardSquare from, BoardSquare to, char captured,
+	bool isWhiteKingChecked, bool isBlackKingChecked) {
+	// update bitboards - move the piece back and restore the captured piece (if any)
+	gameTogglePiece(game, game->gameBoard[to.row][to.col], to);
+	gameTogglePiece(game, game->gameBoard[to.row][to.col], from);
+	gameTogglePiece(game, captured, to);
 
 	// move piece back
-	game->gameBoard[histElement.oldSquare.row][histElement.oldSquare.col] = game->gameBoard[histElement.newSquare.row][histElement.newSquare.col];
+	game->gameBoard[from.row][from.col] = game->gameBoard[to.row][to.col];
 
 	// restore element
-	game->gameBoard[histElement.newSquare.row][histElement.newSquare.col] = histElement.prevElementOnNewCell;
+	game->gameBoard[to.row][to.col] = captured;
+
+	// restore king square
+	if (tolower(game->gameBoard[from.row][from.col]) == PIECE_KING) {
+		game->kingSquares[gameGetPieceOwner(game->gameBoard[from.row][from.col])] = from;
+	}
 
 	// change player
 	gameChangePlayer(game);
 
 	// restore check status
-	game->isBlackKingChecked = histElement.isBlackKingChecked;
-	game->isWhiteKingChecked = histElement.isWhiteKingChecked;
+	game->isBlackKingChecked = isBlackKingChecked;
+	game->isWhiteKingChecked = isWhiteKingChecked;
+
+#ifdef GAME_DEBUG
+	assert(game->zobristKey == gameComputeZobristKey(game));
+	assert(game->material[White] == gameComputeMaterial(game, White));
+	assert(game->material[Black] == gameComputeMaterial(game, Black));
+	assert(gameIsEvaluationStateSynced(game));
+	assert(gameIsMailboxSynced(game));
+#endif
+}
+
+void gameForceSetMove(Game * game, BoardSquare from, BoardSquare to) {	
+	HistoryElement histElement = { from, to, game->gameBoard[to.row][to.col],
+		game->isWhiteKingChecked, game->isBlackKingChecked };
+
+	// add to history
+	arrayListAddLast(game->history, histElement);
+
+	gameApplyMove(game, from, to);
+}
+
+/*
+This is a PRIVATE method that is used to undo a move without any checks.
+THIS FUNCTION SHOULD BE WRAPPED BEFORE USING IN GAME.
+*/
+static void gameForceUndoPrevMove(Game * game) {
+	HistoryElement histElement = arrayListGetLast(game->history);
+	arrayListRemoveLast(game->history);
+
+	gameRevertMove(game, histElement.oldSquare, histElement.newSquare, histElement.prevElementOnNewCell,
+		histElement.isWhiteKingChecked, histElement.isBlackKingChecked);
+}
+
+void gameMakeMove(Game * game, GameMove move) {
+	BoardSquare from = gameMoveGetSource(move), to = gameMoveGetDestination(move);
+	GameUndo * undo;
+
+	PROFILER_START(ProfilerGameMakeMove);
+
+#ifdef GAME_DEBUG
+	assert(game->undoStackSize <= GAME_MAX_SEARCH_DEPTH);
+#endif
+
+	undo = &game->undoStack[game->undoStackSize++];
+	undo->move = move;
+	undo->captured = game->gameBoard[to.row][to.col];
+	undo->flags = (game->isWhiteKingChecked ? GAME_UNDO_FLAG_WHITE_CHECKED : 0) |
+		(game->isBlackKingChecked ? GAME_UNDO_FLAG_BLACK_CHECKED : 0);
+
+	gameApplyMove(game, from, to);
+
+	PROFILER_STOP(ProfilerGameMakeMove);
+}
+
+void gameUnmakeMove(Game * game) {
+	GameUndo * undo;
+
+	PROFILER_START(ProfilerGameUnmakeMove);
+
+#ifdef GAME_DEBUG
+	assert(game->undoStackSize > 0);
+#endif
+
+	undo = &game->undoStack[--game->undoStackSize];
+
+	gameRevertMove(game, gameMoveGetSource(undo->move), gameMoveGetDestination(undo->move), undo->captured,
+		(undo->flags & GAME_UNDO_FLAG_WHITE_CHECKED) != 0, (undo->flags & GAME_UNDO_FLAG_BLACK_CHECKED) != 0);
+
+	PROFILER_STOP(ProfilerGameUnmakeMove);
+}
+
+bool gameIsUndoStackFull(Game * game) {
+	return game->undoStackSize >= GAME_MAX_SEARCH_DEPTH;
 }
 
 bool gameIsCurrentPlayerChecked(Game * game) {
@@ -500,40 +1023,21 @@ bool gameIsCurrentPlayerChecked(Game * game) {
 	return game->isBlackKingChecked;
 }
 
-/*
-Checks if a black piece is threatened by a white piece.
-*/
-static bool gameIsBlackPieceThreatened(ChessBoard gameBoard, BoardSquare s) {
-	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER] = { {false} };
-
-	for (int i = 0; i < BOARD_ROWS_NUMBER; i++) {
-		for (int j = 0; j < BOARD_COLUMNS_NUMBER; j++) {
-			if (islower(gameBoard[i][j])) {
-				gameGetLegalMoves(gameBoard, movesBoard, (BoardSquare) { i, j });
-				if (movesBoard[s.row][s.col]) return true;
-			}
-		}
+bool gameIsOtherPlayerChecked(Game * game) {
+	if (gameGetCurrentPlayer(game) == White) {
+		return game->isBlackKingChecked;
 	}
 
-	return false;
+	return game->isWhiteKingChecked;
 }
 
 /*
 Checks if the piece in square s is threatened.
 */
 static bool gameIsPieceThreatened(ChessBoard gameBoard, BoardSquare s) {
-	bool retValue;
-	
-	// check if the piece is black
-	if (isupper(gameBoard[s.row][s.col])) return gameIsBlackPieceThreatened(gameBoard, s);
+	ChessPlayer owner = gameGetPieceOwner(gameBoard[s.row][s.col]);
 
-	// else - rotate
-	rotateBoardAndSwitchColors(gameBoard);
-	retValue = gameIsBlackPieceThreatened(gameBoard, 
-		(BoardSquare) { BOARD_ROWS_NUMBER - 1 - s.row, BOARD_COLUMNS_NUMBER - 1 - s.col });
-	rotateBoardAndSwitchColors(gameBoard);
-
-	return retValue;
+	return gameIsSquareAttacked(gameBoard, s, gameGetOpponent(owner));
 }
 
 /*
@@ -554,12 +1058,12 @@ static void gameDoesMoveCreateKingThreatOrPieceThreat(Game * game, BoardSquare f
 	bool * moveCreatesKingThreat, bool * moveCreatesPieceThreat) {
 	bool isWhitePiece = islower(game->gameBoard[from.row][from.col]);
 
-	gameForceSetMove(game, from, to);
+	gameMakeMove(game, gameMoveCreate(from, to));
 
 	*moveCreatesKingThreat = isWhitePiece ? game->isWhiteKingChecked : game->isBlackKingChecked;
 	*moveCreatesPieceThreat = gameIsPieceThreatened(game->gameBoard, to);
 
-	gameForceUndoPrevMove(game);
+	gameUnmakeMove(game);
 }
 
 
@@ -567,6 +1071,8 @@ void gameGetMovesByTypes(Game * game, bool movesBoard[BOARD_ROWS_NUMBER][BOARD_C
 	MovesBoardWithTypes movesBoardWithTypes, BoardSquare s) {
 	bool moveCaptures, moveCreatesPieceThreat = false, moveCreatesKingThreat = false;
 
+	PROFILER_START(ProfilerGameGetMovesByTypes);
+
 	for (int i = 0; i < BOARD_ROWS_NUMBER; i++) {
 		for (int j = 0; j < BOARD_COLUMNS_NUMBER; j++) {
 			if (!movesBoard[i][j]) movesBoardWithTypes[i][j] = BoardSquareInvalidMove;
@@ -591,6 +1097,106 @@ void gameGetMovesByTypes(Game * game, bool movesBoard[BOARD_ROWS_NUMBER][BOARD_C
 			}
 		}
 	}
+
+	PROFILER_STOP(ProfilerGameGetMovesByTypes);
+}
+
+/*
+Returns true iff the move leaves the king of the player that made it threatened.
+*/
+static bool gameDoesMoveCreateKingThreat(Game * game, BoardSquare from, BoardSquare to) {
+	ChessPlayer player = gameGetPieceOwner(game->gameBoard[from.row][from.col]);
+	bool moveCreatesKingThreat;
+
+	gameMakeMove(game, gameMoveCreate(from, to));
+	moveCreatesKingThreat = (player == White) ? game->isWhiteKingChecked : game->isBlackKingChecked;
+	gameUnmakeMove(game);
+
+	return moveCreatesKingThreat;
+}
+
+/*
+Adds the moves from the square with the index from to each of the destinations, column by column.
+If validOnly is true, moves that leave the king of the player threatened are not added.
+*/
+static void gameAddMovesToList(Game * game, MoveList * moveList, int from, Bitboard destinations, bool validOnly) {
+	Bitboard enemy = game->bitboards.occupied[gameGetOtherPlayer(game)], columnDestinations;
+	BoardSquare fromSquare = { BITBOARD_INDEX_ROW(from), BITBOARD_INDEX_COL(from) };
+	int to;
+
+	for (int col = 0; col < BOARD_COLUMNS_NUMBER && destinations; col++) {
+		columnDestinations = destinations & BITBOARD_COLUMN(col);
+		destinations &= ~columnDestinations;
+
+		while (columnDestinations) {
+			to = bitboardPopLeastSignificantIndex(&columnDestinations);
+
+			if (validOnly && gameDoesMoveCreateKingThreat(game, fromSquare,
+				(BoardSquare) { BITBOARD_INDEX_ROW(to), BITBOARD_INDEX_COL(to) })) continue;
+
+			moveList->moves[moveList->size++] = GAME_MOVE_CREATE(from, to,
+				(enemy & ((Bitboard)1 << to)) ? GAME_MOVE_FLAG_CAPTURE : 0);
+		}
+	}
+}
+
+/*
+Fills moveList with the moves of the current player. See gameGenerateMoves and gameGeneratePseudoLegalMoves.
+The destinations of each piece are generated on the mailbox if GAME_MAILBOX is defined, and on the bitboards
+otherwise. Both give the same moves in the same order.
+*/
+static void gameGenerateMovesByMode(Game * game, MoveList * moveList, bool validOnly) {
+	ChessPlayer player = gameGetCurrentPlayer(game);
+	Bitboard columnPieces, destinations;
+	BoardSquare fromSquare;
+	int from;
+
+	moveList->size = 0;
+
+	for (int col = 0; col < BOARD_COLUMNS_NUMBER; col++) {
+		columnPieces = game->bitboards.occupied[player] & BITBOARD_COLUMN(col);
+
+		while (columnPieces) {
+			from = bitboardPopLeastSignificantIndex(&columnPieces);
+			fromSquare = (BoardSquare) { BITBOARD_INDEX_ROW(from), BITBOARD_INDEX_COL(from) };
+
+#ifdef GAME_MAILBOX
+			destinations = gameMailboxGetPieceMoves(game->mailbox, fromSquare);
+#else
+			destinations = gameBitboardGetPieceMoves(&game->bitboards,
+				gameGetBitboardPieceType(game->gameBoard[fromSquare.row][fromSquare.col]), player, (Bitboard)1 << from);
+#endif
+
+#ifdef GAME_DEBUG
+			// both generators must agree
+			assert(destinations == gameMailboxGetPieceMoves(game->mailbox, fromSquare));
+			assert(destinations == gameBitboardGetPieceMoves(&game->bitboards,
+				gameGetBitboardPieceType(game->gameBoard[fromSquare.row][fromSquare.col]), player, (Bitboard)1 << from));
+#endif
+
+			gameAddMovesToList(game, moveList, from, destinations, validOnly);
+		}
+	}
+}
+
+void gameGenerateMoves(Game * game, MoveList * moveList) {
+	PROFILER_START(ProfilerGameGenerateMoves);
+	gameGenerateMovesByMode(game, moveList, true);
+	PROFILER_STOP(ProfilerGameGenerateMoves);
+}
+
+void gameGeneratePseudoLegalMoves(Game * game, MoveList * moveList) {
+	PROFILER_START(ProfilerGameGeneratePseudoLegalMoves);
+	gameGenerateMovesByMode(game, moveList, false);
+	PROFILER_STOP(ProfilerGameGeneratePseudoLegalMoves);
+}
+
+BoardSquare gameMoveGetSource(GameMove move) {
+	return (BoardSquare) { BITBOARD_INDEX_ROW(GAME_MOVE_FROM(move)), BITBOARD_INDEX_COL(GAME_MOVE_FROM(move)) };
+}
+
+BoardSquare gameMoveGetDestination(GameMove move) {
+	return (BoardSquare) { BITBOARD_INDEX_ROW(GAME_MOVE_TO(move)), BITBOARD_INDEX_COL(GAME_MOVE_TO(move)) };
 }
 
 ChessPlayer gameGetCurrentPlayer(Game * game) {
@@ -620,8 +1226,30 @@ Like get moves by types, but doesn't require a movesBoard as an argument.
 */
 static void gameGetMovesByTypesWrapper(Game * game, MovesBoardWithTypes movesBoardWithTypes, BoardSquare s) {
 	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER] = { {false} };
+#ifdef GAME_DEBUG
+	bool otherMovesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER] = { {false} };
+#endif
+
+#ifdef GAME_MAILBOX
+	gameMailboxGetLegalMoves(game, movesBoard, s);
+#else
+	gameBitboardGetLegalMoves(game, movesBoard, s);
+#endif
+
+#ifdef GAME_DEBUG
+	// all the generators must agree
+	gameGetLegalMoves(game->gameBoard, otherMovesBoard, s);
+	assert(memcmp(movesBoard, otherMovesBoard, sizeof(otherMovesBoard)) == 0);
+
+	memset(otherMovesBoard, 0, sizeof(otherMovesBoard));
+	gameBitboardGetLegalMoves(game, otherMovesBoard, s);
+	assert(memcmp(movesBoard, otherMovesBoard, sizeof(otherMovesBoard)) == 0);
+
+	memset(otherMovesBoard, 0, sizeof(otherMovesBoard));
+	gameMailboxGetLegalMoves(game, otherMovesBoard, s);
+	assert(memcmp(movesBoard, otherMovesBoard, sizeof(otherMovesBoard)) == 0);
+#endif
 
-	gameGetLegalMoves(game->gameBoard, movesBoard, s);
 	gameGetMovesByTypes(game, movesBoard, movesBoardWithTypes, s);
 }
 
@@ -669,55 +1297,51 @@ GAME_MESSAGE gameUndoPrevMove(Game * game) {
 }
 
 /*
-Switch the player colors. Rotates the board and changes the current player.
+True iff one of the moves of the current player is valid. Makes the moves one by one, until the first valid move.
 */
-static void gameSwitchPlayersColors(Game * game) {
-	rotateBoardAndSwitchColors(game->gameBoard);
-	gameChangePlayer(game);
-}
+static bool gameCurrentPlayerHasValidMovesByMaking(Game * game) {
+	MoveList moveList;
+	bool moveIsValid;
 
-/*
-Returns true iff the piece on square s has a valid move (a move that creates a threat 
-on the current player is not valid).
-*/
-static bool gamePieceHasNextMove(Game * game, BoardSquare s) {
-	MovesBoardWithTypes movesBoardWithTypes = { {BoardSquareInvalidMove} };
+	gameGeneratePseudoLegalMoves(game, &moveList);
 
-	gameGetMovesByTypesWrapper(game, movesBoardWithTypes, s);
+	for (int i = 0; i < moveList.size; i++) {
+		gameMakeMove(game, moveList.moves[i]);
+		moveIsValid = !gameIsOtherPlayerChecked(game);
+		gameUnmakeMove(game);
 
-	for (int i = 0; i < BOARD_ROWS_NUMBER; i++) {
-		for (int j = 0; j < BOARD_COLUMNS_NUMBER; j++) {
-			if (gameIsValidMove(movesBoardWithTypes[i][j])) return true;
-		}
+		if (moveIsValid) return true;
 	}
 
 	return false;
 }
 
-/*
-True iff the current player has next move to do.
-*/
-static bool gameCurrentPlayerHasValidMoves(Game * game) {
-	// work only on white players.
-	bool switchPlayers = (gameGetCurrentPlayer(game) == Black);
-	bool hasNextMove = false;
-	
-	if (switchPlayers) gameSwitchPlayersColors(game);
+bool gameCurrentPlayerHasValidMoves(Game * game) {
+	ChessPlayer player = gameGetCurrentPlayer(game);
+	BoardSquare king = game->kingSquares[player], from;
+	Bitboard pieces = game->bitboards.occupied[player];
+	int index;
 
-	for (int i = 0; i < BOARD_ROWS_NUMBER && !hasNextMove; i++) {
-		for (int j = 0; j < BOARD_COLUMNS_NUMBER; j++) {
-			if (islower(game->gameBoard[i][j])) {
-				if (gamePieceHasNextMove(game, (BoardSquare) { i, j })) {
-					hasNextMove = true;
-					break;
-				}
-			}
+	// a piece that isn't on a line with its king can't be pinned, so if the king isn't checked,
+	// any move of such a piece is valid
+	while (!gameIsCurrentPlayerChecked(game) && pieces) {
+		index = bitboardPopLeastSignificantIndex(&pieces);
+		from = (BoardSquare) { BITBOARD_INDEX_ROW(index), BITBOARD_INDEX_COL(index) };
+
+		if (from.row == king.row || from.col == king.col || abs(from.row - king.row) == abs(from.col - king.col)) {
+			continue;
 		}
-	}
 
-	if (switchPlayers) gameSwitchPlayersColors(game);
+		if (gameBitboardGetPieceMoves(&game->bitboards, gameGetBitboardPieceType(game->gameBoard[from.row][from.col]),
+			player, (Bitboard)1 << index) != BITBOARD_EMPTY) {
+#ifdef GAME_DEBUG
+			assert(gameCurrentPlayerHasValidMovesByMaking(game));
+#endif
+			return true;
+		}
+	}
 
-	return hasNextMove;
+	return gameCurrentPlayerHasValidMovesByMaking(game);
 }
 
 GAME_CHECK_WINNER_MESSAGE gameCheckWinner(Game * game) {
@@ -5,7 +5,13 @@
 #include <string.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <assert.h>
 #include "ArrayList.h"
+#include "Bitboard.h"
+#include "Mailbox.h"
+#include "Zobrist.h"
+#include "Evaluation.h"
+#include "Profiler.h"
 #include "ChessGlobalDefinitions.h"
 
 /*
@@ -13,6 +19,16 @@ Game Summary:
 This module is an encapsulation of the game. It contains the gameboard, history,
 current player, and boolean indicators regarding whether the king of each player is threatened.
 
+The gameboard is also kept as a set of bitboards (one per player and piece type), which are used by
+the move generation, and as a mailbox (see Mailbox.h), which is used instead by the move generation and the check
+detection when compiling with GAME_MAILBOX defined. The char gameboard is the view that is used for printing and for the GUI.
+The square of each king is tracked as well, so check detection doesn't need to search for the king.
+The zobrist key of the position (see Zobrist.h) is updated on every move, and identifies the position.
+
+Compiling with GAME_DEBUG defined enables self-checks of the incrementally updated state, and checks that
+the move generators, the check detections and the valid move tests agree.
+Compiling with GAME_PROFILE defined counts and times the hot functions (see Profiler.h).
+
 A game should be handled with the GameHandler module, which wraps it with the settings and handles 
 the game flow. 
 */
@@ -55,12 +71,67 @@ typedef enum square_type_e {
 
 typedef BoardSquareMoveType MovesBoardWithTypes[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER];
 
+/*
+A move packed into 16 bits: the source square index (bits 0-5), the destination square index
+(bits 6-11) and the move flags (bits 12-15). A square index is row * 8 + col.
+*/
+typedef uint16_t GameMove;
+
+#define GAME_MOVE_FLAG_CAPTURE 0x1
+#define GAME_MOVE_CREATE(from, to, flags) ((GameMove)((from) | ((to) << 6) | ((flags) << 12)))
+#define GAME_MOVE_FROM(move) ((move) & 0x3F)
+#define GAME_MOVE_TO(move) (((move) >> 6) & 0x3F)
+#define GAME_MOVE_FLAGS(move) ((move) >> 12)
+
+#define GAME_MAX_MOVES_NUMBER 256 // more than the maximum number of moves in a chess position
+
+/*
+A list of moves, filled by gameGenerateMoves.
+*/
+typedef struct move_list_t {
+	GameMove moves[GAME_MAX_MOVES_NUMBER];
+	int size;
+} MoveList;
+
+#define GAME_MAX_SEARCH_DEPTH 64 // the maximum number of moves on the undo stack of a game
+
+/*
+An entry of the undo stack: the move, the piece that was on the destination square (BOARD_EMPTY_CELL
+if none) and the check status before the move. Unlike a HistoryElement, it takes only 4 bytes.
+*/
+typedef struct game_undo_t {
+	GameMove move;
+	char captured;
+	unsigned char flags;
+} GameUndo;
+
+#define GAME_UNDO_FLAG_WHITE_CHECKED 0x1
+#define GAME_UNDO_FLAG_BLACK_CHECKED 0x2
+
+/*
+The bitboards of the game. Both arrays are indexed by ChessPlayer.
+*/
+typedef struct game_bitboards_t {
+	Bitboard pieces[2][BitboardPieceTypesNumber];
+	Bitboard occupied[2];
+} GameBitboards;
+
 typedef struct game_t {
 	ChessBoard gameBoard;
+	GameBitboards bitboards;
+	Mailbox mailbox;
+	BoardSquare kingSquares[2]; // indexed by ChessPlayer, { -1, -1 } if the king is not on the board
+	ZobristKey zobristKey;
+	int material[2]; // the sum of the piece values of each player, indexed by ChessPlayer
+	EvaluationState evaluation; // the piece-square table scores of the pieces on the board
 	ChessPlayer currentPlayer;
 	bool isBlackKingChecked;
 	bool isWhiteKingChecked;
 	ArrayList * history;
+	// the moves made by gameMakeMove, which are not saved to the history. It has one more entry than
+	// GAME_MAX_SEARCH_DEPTH for the legality checks of the game functions
+	GameUndo undoStack[GAME_MAX_SEARCH_DEPTH + 1];
+	int undoStackSize;
 } Game;
 
 /**
@@ -95,6 +166,27 @@ Creates a game instance, with the initial Checkmate game state.
 @return the game instance, or NULL if malloc failed
 */
 Game * gameCreate(int historySize);
+
+/*
+Creates an independent copy of the game: the board, the current player, the check status
+and the history (with the same history size). Changes to one of the games don't affect the other.
+@param game the game to copy
+@return the new game instance, or NULL if game is NULL or malloc failed
+*/
+Game * gameClone(Game * game);
+
+/*
+Copies the game into an existing game instance (for example, a game from gameCreate or an earlier copy):
+the board, the current player, the check status and the history. No memory is allocated - the history
+is copied into the history of dst, which keeps its capacity.
+@param src the game to copy
+@param dst the game to copy into
+@return
+GAME_INVALID_ARGUMENT - if src or dst are NULL, or the history of src doesn't fit in the history of dst
+(dst is not affected).
+GAME_SUCCESS - otherwise.
+*/
+GAME_MESSAGE gameCopyInto(Game * src, Game * dst);
 	
 /*
 Destroys the game instance and frees all memory.
@@ -102,6 +194,14 @@ Destroys the game instance and frees all memory.
 */
 void gameDestroy(Game * game);
 
+/*
+Recomputes the game state that is derived from the game board and the current player (the bitboards,
+the zobrist key, the king squares and the check status of both kings).
+Must be called after the game board has been modified directly, i.e not by a move.
+@param game - the game instance
+*/
+void gameSyncBoardState(Game * game);
+
 /*
 Returns true iff the square s is on the board.
 @param s the square
@@ -126,14 +226,39 @@ GAME_MESSAGE gameSetMove(Game * game, BoardSquare from, BoardSquare to);
 /*
 Sets a move with without performing any checks and even if the move causes a threat.
 Saves the move to history.
-THIS FUNCTION SHOULD BE WRAPPED BEFORE USING IN GAME, AND IS PUBLIC ONLY FOR 
-OPTIMIZATION OF THE MINIMAX ALGORITHM.
+THIS FUNCTION SHOULD BE WRAPPED BEFORE USING IN GAME (the minimax algorithm uses gameMakeMove).
 @param game the game
 @param from the source square
 @param to the destination square
 */
 void gameForceSetMove(Game * game, BoardSquare from, BoardSquare to);
 
+/*
+Makes a move without performing any checks, like gameForceSetMove, but saves it to the undo stack of the
+game instead of the history, so no memory is touched outside of the game. Assumes that the undo stack
+is not full (see gameIsUndoStackFull).
+Moves made by this function must be undone by gameUnmakeMove (in reverse order) before the history
+of the game is used.
+THIS FUNCTION IS INTENDED FOR THE MINIMAX ALGORITHM.
+@param game the game
+@param move the move
+*/
+void gameMakeMove(Game * game, GameMove move);
+
+/*
+Undoes the last move that was made by gameMakeMove. Assumes that the undo stack is not empty.
+@param game the game
+*/
+void gameUnmakeMove(Game * game);
+
+/*
+Checks if the undo stack is full, i.e. there are GAME_MAX_SEARCH_DEPTH moves that were made by gameMakeMove
+and not undone yet.
+@param game the game
+@return true iff no more moves may be made by gameMakeMove
+*/
+bool gameIsUndoStackFull(Game * game);
+
 /*
 Undo the previous move.
 @return - one of the following messages (self explanatory)
@@ -176,6 +301,26 @@ and movesBoard is initialized to false. Doesn't check threats.
 void gameGetLegalMoves(ChessBoard gameBoard,
 	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s);
 
+/*
+Same as gameGetLegalMoves, but uses the bitboards of the game instead of scanning the game board.
+Assumes all arguments are valid and movesBoard is initialized to false. Doesn't check threats.
+@param game the game
+@param movesBoard a boolean board represents legal moves
+@param s the square of the piece
+*/
+void gameBitboardGetLegalMoves(Game * game,
+	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s);
+
+/*
+Same as gameGetLegalMoves, but steps on the mailbox of the game instead of the game board.
+Assumes all arguments are valid and movesBoard is initialized to false. Doesn't check threats.
+@param game the game
+@param movesBoard a boolean board represents legal moves
+@param s the square of the piece
+*/
+void gameMailboxGetLegalMoves(Game * game,
+	bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER], BoardSquare s);
+
 /*
 Gets a moves board with all the legal moves of the piece in square s, and sets the moves types
 in the movesBoardWithTypes board.
@@ -187,6 +332,36 @@ in the movesBoardWithTypes board.
 void gameGetMovesByTypes(Game * game, bool movesBoard[BOARD_ROWS_NUMBER][BOARD_COLUMNS_NUMBER],
 	MovesBoardWithTypes movesBoardWithTypes, BoardSquare s);
 
+/*
+Fills moveList with all the valid moves of the current player (moves that leave the king of the
+current player threatened are not included), in a single pass over the pieces of the player.
+The moves are ordered by the source square and then by the destination square, column by column.
+Only the GAME_MOVE_FLAG_CAPTURE flag is set; threat types are not computed.
+@param game the game
+@param moveList the list to fill
+*/
+void gameGenerateMoves(Game * game, MoveList * moveList);
+
+/*
+Like gameGenerateMoves, but also includes moves that leave the king of the current player threatened
+(pseudo-legal moves). This is much cheaper, as no move is made during the generation.
+THIS FUNCTION IS INTENDED FOR THE MINIMAX ALGORITHM: the caller has to make each move with
+gameMakeMove and skip it if gameIsOtherPlayerChecked returns true.
+@param game the game
+@param moveList the list to fill
+*/
+void gameGeneratePseudoLegalMoves(Game * game, MoveList * moveList);
+
+/*
+Returns the source square of a packed move.
+*/
+BoardSquare gameMoveGetSource(GameMove move);
+
+/*
+Returns the destination square of a packed move.
+*/
+BoardSquare gameMoveGetDestination(GameMove move);
+
 /*
 Determines whether the king of the given player is in check state.
 Checks the game board and not the game states.
@@ -195,6 +370,26 @@ Checks the game board and not the game states.
 */
 bool gameBoardKingIsChecked(ChessBoard gameBoard, ChessPlayer player);
 
+/*
+Determines whether the square s is attacked by any piece of the given player, i.e whether a piece
+of the other player on that square could be captured. Scans outward from s along the knight jumps,
+pawn diagonals, king steps and sliding rays, instead of generating the moves of the attacker.
+@param gameBoard - the game board
+@param s - the square, assumed to be on the board
+@param attacker - the attacking player
+@return true iff the square is attacked
+*/
+bool gameIsSquareAttacked(ChessBoard gameBoard, BoardSquare s, ChessPlayer attacker);
+
+/*
+Same as gameIsSquareAttacked, but scans the mailbox of the game instead of the game board.
+@param game the game
+@param s - the square, assumed to be on the board
+@param attacker - the attacking player
+@return true iff the square is attacked
+*/
+bool gameMailboxIsSquareAttacked(Game * game, BoardSquare s, ChessPlayer attacker);
+
 /*
 Gets the current player.
 If game is null, return value is undefined.
@@ -218,6 +413,23 @@ Checks if the current player is checked.
 */
 bool gameIsCurrentPlayerChecked(Game * game);
 
+/*
+Checks if the other player (the player that made the last move) is checked.
+After gameMakeMove, true means that the move was not valid.
+@param game the game
+@return true iff the other player is checked
+*/
+bool gameIsOtherPlayerChecked(Game * game);
+
+/*
+Checks if the current player has a valid move. Stops at the first valid move, and makes a move only if
+every piece that isn't on a line with the king can't move (or the king is checked), so it's cheap enough
+for the leaves of the search.
+@param game the game
+@return true iff the current player has a valid move
+*/
+bool gameCurrentPlayerHasValidMoves(Game * game);
+
 /*
 Check if there is a winner or it's a draw (i.e, checks if the current player is losing or 
 has no more moves but is not threatened).
@@ -252,6 +464,30 @@ Changes the current player.
 */
 void gameChangePlayer(Game * game);
 
+/*
+Returns the material value of a piece (of any player): 1 for a pawn, 3 for a knight or a bishop,
+5 for a rook, 9 for a queen and 100 for a king.
+Assumes piece is one of the valid pieces (in any case).
+*/
+int gameGetPieceValue(char piece);
+
+/*
+Computes the material of the player from scratch by scanning the board (the game keeps it
+updated incrementally in game->material).
+@param game the game
+@param player the player
+@return the sum of the values of the pieces of the player
+*/
+int gameComputeMaterial(Game * game, ChessPlayer player);
+
+/*
+Computes the zobrist key of the position from scratch (the game keeps it updated incrementally
+in game->zobristKey).
+@param game the game
+@return the zobrist key of the game board and the current player
+*/
+ZobristKey gameComputeZobristKey(Game * game);
+
 /*
 Return true iff the move is valid (i.e, doesn't creates a king's threat
 or invalid according to the rules.
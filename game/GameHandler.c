@@ -7,28 +7,42 @@ GameHandler * gameHandlerNewGame(GhSettings settings) {
 	gh->settings.gameMode = settings.gameMode;
 	gh->settings.difficultyLevel = settings.difficultyLevel;
 	gh->settings.userColor = settings.userColor;
+	gh->settings.computerMoveTimeMs = settings.computerMoveTimeMs;
+	gh->settings.searchThreadsNumber = settings.searchThreadsNumber;
+	gh->settings.searchParallelMode = settings.searchParallelMode;
 
 	gh->gameIsSaved = false;
+	gh->lastSearchStats = (MinimaxStats) { 0 };
 	
-	// the size of the history allows using the minimax algorithm
-	gh->game = gameCreate(GH_DEFAULT_HISTORY_SIZE + gh->settings.difficultyLevel);
-	if (gh->game == NULL) return NULL;
+	// the minimax algorithm uses the undo stack of the game, so the history holds only the moves of the users
+	gh->game = gameCreate(GH_DEFAULT_HISTORY_SIZE);
+	gh->moveLog = moveLogCreate();
+	if (gh->game == NULL || gh->moveLog == NULL) {
+		gameHandlerDestroy(gh);
+		return NULL;
+	}
 
 	return gh;
 }
 
 bool gameHandlerRestartGame(GameHandler * gh) {
-	Game * prevGame = gh->game;
+	Game * game = gameCreate(GH_DEFAULT_HISTORY_SIZE);
+	MoveLog * moveLog = moveLogCreate();
 
-	gh->game = gameCreate(GH_DEFAULT_HISTORY_SIZE + gh->settings.difficultyLevel);
-	if (gh->game == NULL) {
-		gh->game = prevGame;
+	if (game == NULL || moveLog == NULL) {
+		gameDestroy(game);
+		moveLogDestroy(moveLog);
 		return false;
 	}
 
+	gameDestroy(gh->game);
+	moveLogDestroy(gh->moveLog);
+
+	gh->game = game;
+	gh->moveLog = moveLog;
+	gh->lastSearchStats = (MinimaxStats) { 0 };
 	gh->gameIsSaved = false;
 
-	gameDestroy(prevGame);
 	return true;
 }
 
@@ -47,6 +61,7 @@ void gameHandlerDestroy(GameHandler * gh) {
 	if (gh == NULL) return;
 
 	gameDestroy(gh->game);
+	moveLogDestroy(gh->moveLog);
 	free(gh);
 }
 
@@ -56,6 +71,9 @@ GhSettings gameHandlerGetDefaultSettings() {
 	settings.gameMode = GameModeSinglePlayer;
 	settings.difficultyLevel = GameDifficultyEasy;
 	settings.userColor = UserColorWhite;
+	settings.computerMoveTimeMs = 0;
+	settings.searchThreadsNumber = 1;
+	settings.searchParallelMode = MinimaxParallelRootSplit;
 
 	return settings;
 }
@@ -66,12 +84,82 @@ void gameHandlerGameElementAddedToHistory(GameHandler * gh) {
 	}
 }
 
+/*
+Adds the last move of the game history to the move log. A failure to log doesn't fail the move,
+it's only missing from the log.
+*/
+static void gameHandlerLogLastMove(GameHandler * gh, MoveLogEntryType type, long long searchTimeMs) {
+	HistoryElement histElement = arrayListGetLast(gh->game->history);
+	MoveLogEntry entry = { .type = type, .player = gameGetOtherPlayer(gh->game),
+		.from = histElement.oldSquare, .to = histElement.newSquare,
+		.piece = gh->game->gameBoard[histElement.newSquare.row][histElement.newSquare.col],
+		.capturedPiece = histElement.prevElementOnNewCell, .searchTimeMs = searchTimeMs };
+
+	if (type == MoveLogEntryComputerMove) entry.searchStats = gh->lastSearchStats;
+
+	moveLogAppend(gh->moveLog, entry);
+}
+
+GAME_MESSAGE gameHandlerSetUserMove(GameHandler * gh, BoardSquare from, BoardSquare to) {
+	GAME_MESSAGE msg = gameSetMove(gh->game, from, to);
+
+	if (msg == GAME_MOVE_SUCCESS || msg == GAME_MOVE_SUCCESS_CAPTURE) {
+		gameHandlerLogLastMove(gh, MoveLogEntryUserMove, 0);
+		gameHandlerGameElementAddedToHistory(gh);
+	}
+
+	return msg;
+}
+
+GAME_MESSAGE gameHandlerUndoPrevMove(GameHandler * gh) {
+	HistoryElement histElement = arrayListGetLast(gh->game->history);
+	MoveLogEntry entry;
+	GAME_MESSAGE msg = gameUndoPrevMove(gh->game);
+
+	if (msg == GAME_UNDO_SUCCESS) {
+		entry = (MoveLogEntry) { .type = MoveLogEntryUndo, .player = gameGetCurrentPlayer(gh->game),
+			.from = histElement.oldSquare, .to = histElement.newSquare,
+			.piece = gh->game->gameBoard[histElement.oldSquare.row][histElement.oldSquare.col],
+			.capturedPiece = histElement.prevElementOnNewCell };
+
+		moveLogAppend(gh->moveLog, entry);
+	}
+
+	return msg;
+}
+
 void gameHandlerComputerTurn(GameHandler * gh) {
-	Move suggestMove = minimaxSuggestMove(gh->game, gh->settings.difficultyLevel);
-	gameSetMove(gh->game, suggestMove.oldSquare, suggestMove.newSquare);
+	Move suggestMove;
+	GAME_MESSAGE msg;
+	long long searchStartMs = moveLogGetElapsedMs(gh->moveLog);
+
+	PROFILER_START(ProfilerComputerTurn);
+
+	minimaxSetThreadsNumber(gh->settings.searchThreadsNumber);
+	minimaxSetParallelMode(gh->settings.searchParallelMode);
+
+	// with a time budget, search as deep as possible within the budget (up to the difficulty level)
+	if (gh->settings.computerMoveTimeMs > 0) {
+		suggestMove = minimaxSuggestMoveTimed(gh->game, gh->settings.difficultyLevel, gh->settings.computerMoveTimeMs);
+	}
+	else suggestMove = minimaxSuggestMove(gh->game, gh->settings.difficultyLevel);
+
+	gh->lastSearchStats = minimaxGetLastSearchStats();
+
+	msg = gameSetMove(gh->game, suggestMove.oldSquare, suggestMove.newSquare);
+
+	PROFILER_STOP(ProfilerComputerTurn);
+
+	if (msg != GAME_MOVE_SUCCESS && msg != GAME_MOVE_SUCCESS_CAPTURE) return;
+
+	gameHandlerLogLastMove(gh, MoveLogEntryComputerMove, moveLogGetElapsedMs(gh->moveLog) - searchStartMs);
 	gameHandlerGameElementAddedToHistory(gh);
 }
 
+MinimaxStats gameHandlerGetLastSearchStats(GameHandler * gh) {
+	return gh->lastSearchStats;
+}
+
 void gameHandlerPrintGameSettingsToFileHandler(FILE * fh, GhSettings settings) {
 	char * difficulty;
 
@@ -119,6 +207,16 @@ bool gameHandlerSaveGame(GameHandler * gh, char * path) {
 	return false;
 }
 
+bool gameHandlerExportMoveLog(GameHandler * gh, char * path) {
+	FILE * fh = fopen(path, "w");
+
+	if (fh == NULL) return false;
+
+	moveLogPrintToFileHandler(fh, gh->moveLog);
+
+	return fclose(fh) == 0;
+}
+
 /*
 Convert difficulty text to enum.
 */
@@ -197,8 +295,9 @@ GameHandler * gameHandlerLoadGame(char * path) {
 	}
 
 	gh->gameIsSaved = true;
-	gh->game->isWhiteKingChecked = gameBoardKingIsChecked(gh->game->gameBoard, White);
-	gh->game->isBlackKingChecked = gameBoardKingIsChecked(gh->game->gameBoard, Black);
+
+	// restore the bitboards, king squares and check status of the loaded board
+	gameSyncBoardState(gh->game);
 
 	return gh;
 }
\ No newline at end of file
@@ -1,9 +1,9 @@
 #ifndef GAME_HANDLER_H_
 #define GAME_HANDLER_H_
 
-#include "Minimax.h"
+#include "MoveLog.h"
 
-#define GH_DEFAULT_HISTORY_SIZE 7 // 3 for each user, 1 for threat checking
+#define GH_DEFAULT_HISTORY_SIZE 7 // 3 for each user, 1 for the move that is added before the oldest is removed
 #define GH_GAME_HISTORY_SIZE 6 // 3 for each user
 #define GH_SAVE_FILE_MAX_LINE_LENGTH 40
 #define GH_MAX_DIFFICULTY_LENGTH 10
@@ -48,6 +48,16 @@ typedef struct gh_settings_t {
 	GhGameMode gameMode;
 	GhGameDifficultyLevel difficultyLevel;
 	GhUserColor userColor;
+
+	// the time budget of a computer move in milliseconds, or 0 to always search to the full depth.
+	// The difficulty level is the maximum depth in both cases. Not saved to game files.
+	int computerMoveTimeMs;
+
+	// the number of threads of the computer move search (1 to MINIMAX_MAX_THREADS_NUMBER). Not saved to game files.
+	int searchThreadsNumber;
+
+	// how a search with more than one thread is parallelized. Not saved to game files.
+	MinimaxParallelMode searchParallelMode;
 } GhSettings;
 
 /*
@@ -56,6 +66,8 @@ Game handler struct - the game and its' settings.
 typedef struct gh_t {
 	GhSettings settings;
 	Game * game;
+	MoveLog * moveLog; // everything that was played since the game was created, restarted or loaded
+	MinimaxStats lastSearchStats; // the statistics of the search of the last computer's move
 
 	bool gameIsSaved;
 } GameHandler;
@@ -97,10 +109,34 @@ Manages the game history in order to keep place for game-handling operations.
 void gameHandlerGameElementAddedToHistory(GameHandler * gh);
 
 /*
-Makes a computer's move.
+Makes a user's move (as gameSetMove), and on success adds it to the move log and manages the history.
+@param gh the game handler
+@param from the source square
+@param to the destination square
+@return the message of gameSetMove
+*/
+GAME_MESSAGE gameHandlerSetUserMove(GameHandler * gh, BoardSquare from, BoardSquare to);
+
+/*
+Undoes the previous move (as gameUndoPrevMove), and on success adds the undo to the move log.
+@param gh the game handler
+@return the message of gameUndoPrevMove
+*/
+GAME_MESSAGE gameHandlerUndoPrevMove(GameHandler * gh);
+
+/*
+Makes a computer's move, and adds it to the move log with the statistics of the search.
 */
 void gameHandlerComputerTurn(GameHandler * gh);
 
+/*
+Returns the statistics of the search of the last computer's move (zeroed if the computer hasn't moved
+since the game was created, restarted or loaded).
+@param gh the game handler
+@return the statistics
+*/
+MinimaxStats gameHandlerGetLastSearchStats(GameHandler * gh);
+
 /*
 Saves the game to the specified path.
 @param gh the game handler
@@ -110,6 +146,16 @@ true iff the game has been successfully saved
 */
 bool gameHandlerSaveGame(GameHandler * gh, char * path);
 
+/*
+Exports the move log of the game (everything that was played since the game was created, restarted or loaded)
+to the specified path, one entry per line.
+@param gh the game handler
+@param path the path to export to
+@return
+true iff the log has been successfully exported
+*/
+bool gameHandlerExportMoveLog(GameHandler * gh, char * path);
+
 /*
 Print the game settings to the file handler (stdout or file on disk).
 @param fh the file
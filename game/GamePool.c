@@ -0,0 +1,64 @@
+#include "GamePool.h"
+
+GamePool * gamePoolCreate(int size) {
+	GamePool * pool;
+
+	if (size <= 0) return NULL;
+
+	pool = malloc(sizeof(GamePool));
+	if (pool == NULL) return NULL;
+
+	pool->games = calloc(size, sizeof(Game *));
+	pool->isAcquired = calloc(size, sizeof(bool));
+
+	if (pool->games == NULL || pool->isAcquired == NULL) {
+		free(pool->games);
+		free(pool->isAcquired);
+		free(pool);
+		return NULL;
+	}
+
+	pool->size = size;
+
+	return pool;
+}
+
+void gamePoolDestroy(GamePool * pool) {
+	if (pool == NULL) return;
+
+	for (int i = 0; i < pool->size; i++) gameDestroy(pool->games[i]);
+
+	free(pool->games);
+	free(pool->isAcquired);
+	free(pool);
+}
+
+Game * gamePoolAcquireCopy(GamePool * pool, Game * game) {
+	int i = 0;
+
+	while (i < pool->size && pool->isAcquired[i]) i++;
+	if (i == pool->size) return NULL;
+
+	// a copy into the pooled game fails only if its history is too small - then it's replaced
+	if (pool->games[i] == NULL || gameCopyInto(game, pool->games[i]) != GAME_SUCCESS) {
+		gameDestroy(pool->games[i]);
+
+		pool->games[i] = gameClone(game);
+		if (pool->games[i] == NULL) return NULL;
+	}
+
+	pool->isAcquired[i] = true;
+
+	return pool->games[i];
+}
+
+void gamePoolRelease(GamePool * pool, Game * game) {
+	if (game == NULL) return;
+
+	for (int i = 0; i < pool->size; i++) {
+		if (pool->games[i] == game) {
+			pool->isAcquired[i] = false;
+			return;
+		}
+	}
+}
@@ -0,0 +1,52 @@
+#ifndef GAME_POOL_H_
+#define GAME_POOL_H_
+
+#include "Game.h"
+
+/*
+GamePool Summary:
+A fixed number of game instances that are reused, for code that needs copies of a game again and again
+(for example, a copy for each thread of every search). A game is allocated the first time its slot is
+used, and after that a copy only overwrites it, so no memory is allocated unless the history of the
+copied game is larger than the history of the pooled game.
+
+The pool is not thread safe: acquire and release the games from a single thread
+(the copies themselves may be used by other threads).
+*/
+
+typedef struct game_pool_t {
+	Game ** games; // NULL for a slot that has never been used
+	bool * isAcquired;
+	int size;
+} GamePool;
+
+/*
+Creates an empty pool.
+@param size the maximum number of games
+@return the pool, or NULL if malloc failed or size <= 0
+*/
+GamePool * gamePoolCreate(int size);
+
+/*
+Frees the pool and all its games. Does nothing if pool is NULL.
+The games of the pool must not be used after that.
+@param pool the pool
+*/
+void gamePoolDestroy(GamePool * pool);
+
+/*
+Takes a free game of the pool and makes it a copy of the given game (as gameCopyInto).
+@param pool the pool
+@param game the game to copy
+@return the copy, or NULL if all the games of the pool are in use or malloc failed
+*/
+Game * gamePoolAcquireCopy(GamePool * pool, Game * game);
+
+/*
+Returns a game to the pool. Does nothing if game is NULL or is not a game of the pool.
+@param pool the pool
+@param game a game that was returned by gamePoolAcquireCopy
+*/
+void gamePoolRelease(GamePool * pool, Game * game);
+
+#endif
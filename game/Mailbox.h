@@ -0,0 +1,44 @@
+#ifndef MAILBOX_H_
+#define MAILBOX_H_
+
+#include "Bitboard.h"
+
+/*
+Mailbox Summary:
+A mailbox is the board padded with off-board squares: 12 rows of 10 squares, where the board is held in
+rows 2 to 9 and columns 1 to 8. A step of a piece from a board square moves by a fixed offset of the index,
+and a step that leaves the board (by up to two rows, as a knight jump, or by up to two columns, which wraps
+to the padding column of a neighbouring row) lands on an off-board square. So each step is checked with a
+single test of the square it lands on, instead of four comparisons of the row and the column.
+
+Each square holds its piece as a byte: the piece type (BitboardPieceType) and the color bit of the player,
+MAILBOX_EMPTY for an empty square, or MAILBOX_OFF_BOARD. A piece of a player can move to a square iff the
+square has neither the color of the player nor MAILBOX_OFF_BOARD.
+
+This module contains only board-independent primitives (the layout and the steps).
+The mailbox of a game is kept in the Game struct and is maintained by the Game module.
+*/
+
+#define MAILBOX_SIZE 120
+#define MAILBOX_COLUMNS_NUMBER 10
+#define MAILBOX_INDEX(row, col) (((row) + 2) * MAILBOX_COLUMNS_NUMBER + (col) + 1)
+#define MAILBOX_INDEX_ROW(index) ((index) / MAILBOX_COLUMNS_NUMBER - 2)
+#define MAILBOX_INDEX_COL(index) ((index) % MAILBOX_COLUMNS_NUMBER - 1)
+
+#define MAILBOX_EMPTY 0x00
+#define MAILBOX_WHITE 0x08
+#define MAILBOX_BLACK 0x10
+#define MAILBOX_OFF_BOARD 0x20
+#define MAILBOX_PIECE(color, pieceType) ((unsigned char)((color) | (pieceType)))
+#define MAILBOX_PIECE_TYPE(square) ((BitboardPieceType)((square) & 0x07))
+#define MAILBOX_COLOR(square) ((square) & (MAILBOX_WHITE | MAILBOX_BLACK))
+
+// the offsets of the steps, as array initializers
+#define MAILBOX_KNIGHT_STEPS { -21, -19, -12, -8, 8, 12, 19, 21 }
+#define MAILBOX_KING_STEPS { -11, -9, 9, 11, -10, -1, 1, 10 } // the diagonals first, then the straight lines
+#define MAILBOX_DIAGONAL_STEPS_FIRST 0
+#define MAILBOX_STRAIGHT_STEPS_FIRST 4
+
+typedef unsigned char Mailbox[MAILBOX_SIZE];
+
+#endif
@@ -1,169 +1,940 @@
+#define _POSIX_C_SOURCE 200809L // for clock_gettime
 #include "Minimax.h"
 #include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#define MINIMAX_TIME_CHECK_INTERVAL 1024 // the number of nodes between two checks of the clock
+#define MINIMAX_MATE_VALUE 100000 // more than any evaluation of a position
+#define MINIMAX_MATE_THRESHOLD (MINIMAX_MATE_VALUE - 1000) // the values beyond it are mates (MATE - ply)
+#define MINIMAX_MAX_PLY 64 // the maximum distance from the root, for the killer moves
+#define MINIMAX_SQUARES_NUMBER (BOARD_ROWS_NUMBER * BOARD_COLUMNS_NUMBER)
+#define MINIMAX_DELTA_MARGIN 200 // a positional gain that a capture can add to the captured material, in centipawns
+
+// the ordering scores of the move kinds. Captures and history scores never reach the next kind
+#define MINIMAX_ORDER_HASH_MOVE 1000000
+#define MINIMAX_ORDER_CAPTURE 100000
+#define MINIMAX_ORDER_KILLER_FIRST 90000
+#define MINIMAX_ORDER_KILLER_SECOND 80000
+#define MINIMAX_ORDER_HISTORY_MAX (MINIMAX_ORDER_KILLER_SECOND - 1)
 
 /*
-Gets the abuslote score of a piece.
-Assume piece is valid (i.e. one of the valid pieces).
+The state of a single search.
 */
-static int minimaxGetAbsuloteScoreOfPiece(char piece) {
-	switch (tolower(piece)) {
-	case PIECE_PAWN:
-		return 1;
-	case PIECE_KNIGHT:
-		return 3;
-	case PIECE_BISHOP:
-		return 3;
-	case PIECE_ROOK:
-		return 5;
-	case PIECE_QUEEN:
-		return 9;
-	case PIECE_KING:
-		return 100;
+typedef struct minimax_search_t {
+	long long deadlineMs; // 0 if the search has no time limit
+	MinimaxStats stats;
+	bool aborted; // set when the deadline has passed. The results of an aborted search are meaningless
+	int * stop; // the search is aborted when *stop becomes nonzero (accessed atomically). NULL if not used
+	GameMove killers[MINIMAX_MAX_PLY][2]; // quiet moves that caused a cutoff, per ply (the newest first)
+	int history[MINIMAX_SQUARES_NUMBER][MINIMAX_SQUARES_NUMBER]; // butterfly table: cutoff scores by <from, to>
+	// the table of a root split helper, which is probed before the shared table and stored into instead of it.
+	// NULL if the search uses only the shared table
+	TranspositionTable * privateTable;
+} MinimaxSearch;
+
+// the transposition table that is shared by all searches
+static TranspositionTable * minimaxTable = NULL;
+static int minimaxTableSizeMB = TRANSPOSITION_TABLE_DEFAULT_SIZE_MB;
+
+static int minimaxQuiescenceMaxPly = MINIMAX_QUIESCENCE_DEFAULT_MAX_PLY;
+static int minimaxThreadsNumber = 1;
+static GamePool * minimaxGamePool = NULL; // the copies of the game for the helper threads
+static MinimaxParallelMode minimaxParallelMode = MinimaxParallelRootSplit;
+static MinimaxStats minimaxLastStats = { 0 };
+
+/*
+Returns the score of the position from the point of view of positivePlayer, in centipawns:
+the material plus the tapered piece-square table score.
+The material and the evaluation state are kept updated by the game, so this takes O(1). In GAME_DEBUG
+builds the game checks them against a full scan of the board after every move.
+*/
+static int minimaxScoringFunction(Game * game, ChessPlayer positivePlayer) {
+	int material = game->material[positivePlayer] - game->material[positivePlayer == White ? Black : White];
+
+	return material * EVALUATION_PAWN_VALUE + evaluationGetPositionalScore(&game->evaluation, positivePlayer);
+}
+
+/*
+Returns the value of a node in which the current player has no valid moves: a loss if the
+current player is checked, and a draw otherwise.
+A mate is worth less the farther it is from the root (MINIMAX_MATE_VALUE - ply), so a shorter mate is preferred.
+*/
+static int minimaxGetGameOverValue(Game * game, int ply, bool maximizingPlayer) {
+	if (!gameIsCurrentPlayerChecked(game)) return 0;
+
+	return maximizingPlayer ? -(MINIMAX_MATE_VALUE - ply) : MINIMAX_MATE_VALUE - ply;
+}
+
+/*
+Converts a score of a node at the given ply from a distance to mate from the root to a distance from the node,
+as it's stored in the transposition table (the node may be reached at a different ply later).
+Scores that are not mates are not changed.
+*/
+static int minimaxScoreToTable(int score, int ply) {
+	if (score >= MINIMAX_MATE_THRESHOLD) return score + ply;
+	if (score <= -MINIMAX_MATE_THRESHOLD) return score - ply;
+
+	return score;
+}
+
+/*
+The inverse of minimaxScoreToTable: converts a stored score to a distance to mate from the root.
+*/
+static int minimaxScoreFromTable(int score, int ply) {
+	if (score >= MINIMAX_MATE_THRESHOLD) return score - ply;
+	if (score <= -MINIMAX_MATE_THRESHOLD) return score + ply;
+
+	return score;
+}
+
+/*
+Returns the time in milliseconds from an arbitrary starting point (a monotonic clock).
+*/
+static long long minimaxGetTimeMs() {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/*
+Returns true iff the search has to be aborted because its deadline has passed or it has been stopped.
+Should be called after the node has been counted. The clock is checked only once in
+MINIMAX_TIME_CHECK_INTERVAL nodes.
+*/
+static bool minimaxShouldAbort(MinimaxSearch * search) {
+	long long nodes = search->stats.nodes + search->stats.quiescenceNodes;
+
+	if (search->stop != NULL && __atomic_load_n(search->stop, __ATOMIC_RELAXED)) search->aborted = true;
+
+	if (search->deadlineMs != 0 && nodes % MINIMAX_TIME_CHECK_INTERVAL == 0 &&
+		minimaxGetTimeMs() >= search->deadlineMs) {
+		search->aborted = true;
+	}
+
+	return search->aborted;
+}
+
+/*
+Returns the move as a Move struct.
+*/
+static Move minimaxGetMove(GameMove move) {
+	return (Move) { gameMoveGetSource(move), gameMoveGetDestination(move) };
+}
+
+/*
+Looks for the node in the transposition table (the private table of the search first, if it has one).
+Returns true iff the stored result was searched to the same depth and is sufficient for the alpha-beta window,
+and sets mv to that result in this case.
+Scores are stored from the point of view of the current player, while minimax values are from the point
+of view of the maximizing player.
+hashMove is set to the stored best move even if the result itself can't be used, or to 0 if there's none.
+*/
+static bool minimaxProbeTranspositionTable(MinimaxSearch * search, Game * game, int depth, int ply, int alpha,
+	int beta, bool maximizingPlayer, MoveAndValue * mv, GameMove * hashMove) {
+
+	TranspositionEntry entry;
+	bool isLowerBound;
+
+	*hashMove = 0;
+
+	if (minimaxTable == NULL) return false;
+
+	search->stats.tableProbes++;
+	if ((search->privateTable == NULL || !transpositionTableProbe(search->privateTable, game->zobristKey, &entry)) &&
+		!transpositionTableProbe(minimaxTable, game->zobristKey, &entry)) return false;
+
+	search->stats.tableHits++;
+
+	*hashMove = entry.bestMove;
+	// a deeper result may have a different value, so the value of a node wouldn't depend only on the node
+	if (entry.depth != depth || entry.bestMove == 0) return false;
+
+	mv->value = minimaxScoreFromTable(maximizingPlayer ? entry.score : -entry.score, ply);
+	mv->move = minimaxGetMove(entry.bestMove);
+
+	if (entry.bound == TranspositionBoundExact) return true;
+
+	// a lower bound of the current player score is a lower bound of the value only for the maximizing player
+	isLowerBound = (entry.bound == TranspositionBoundLower) == maximizingPlayer;
+
+	return (isLowerBound && mv->value >= beta) || (!isLowerBound && mv->value <= alpha);
+}
+
+/*
+Stores the result of the node in the transposition table (the private table of the search, if it has one).
+alpha and beta are the original window of the node.
+Mate values are stored by their distance from the node (see minimaxScoreToTable).
+*/
+static void minimaxStoreInTranspositionTable(MinimaxSearch * search, Game * game, int depth, int ply, int alpha,
+	int beta, bool maximizingPlayer, int value, GameMove bestMove) {
+
+	TranspositionBound bound = TranspositionBoundExact;
+
+	if (minimaxTable == NULL) return;
+
+	// bounds of the value, translated to bounds of the current player score
+	if (value <= alpha) bound = maximizingPlayer ? TranspositionBoundUpper : TranspositionBoundLower;
+	else if (value >= beta) bound = maximizingPlayer ? TranspositionBoundLower : TranspositionBoundUpper;
+
+	value = minimaxScoreToTable(value, ply);
+
+	transpositionTableStore(search->privateTable != NULL ? search->privateTable : minimaxTable, game->zobristKey,
+		depth, bound, maximizingPlayer ? value : -value, bestMove);
+}
+
+/*
+Returns the ordering score of a move: the hash move first, then the captures by most valuable victim /
+least valuable attacker, then the killer moves of the ply, and then the other moves by their history score.
+*/
+static int minimaxGetMoveOrderScore(MinimaxSearch * search, Game * game, GameMove move, GameMove hashMove, int ply) {
+	BoardSquare source = gameMoveGetSource(move), destination = gameMoveGetDestination(move);
+	int history;
+
+	if (move == hashMove) return MINIMAX_ORDER_HASH_MOVE;
+
+	if (GAME_MOVE_FLAGS(move) & GAME_MOVE_FLAG_CAPTURE) {
+		return MINIMAX_ORDER_CAPTURE +
+			gameGetPieceValue(game->gameBoard[destination.row][destination.col]) * 100 -
+			gameGetPieceValue(game->gameBoard[source.row][source.col]);
+	}
+
+	if (move == search->killers[ply][0]) return MINIMAX_ORDER_KILLER_FIRST;
+	if (move == search->killers[ply][1]) return MINIMAX_ORDER_KILLER_SECOND;
+
+	history = search->history[GAME_MOVE_FROM(move)][GAME_MOVE_TO(move)];
+
+	return history < MINIMAX_ORDER_HISTORY_MAX ? history : MINIMAX_ORDER_HISTORY_MAX;
+}
+
+/*
+Moves the move with the highest ordering score among the moves from index start onwards to index start
+(a single step of selection sort, so moves that are never tried are never sorted).
+On equal scores, the earlier move is selected, so the generation order is kept.
+*/
+static void minimaxSelectNextMove(MoveList * moveList, int scores[], int start) {
+	int bestIndex = start, tempScore;
+	GameMove tempMove;
+
+	for (int i = start + 1; i < moveList->size; i++) {
+		if (scores[i] > scores[bestIndex]) bestIndex = i;
+	}
+
+	if (bestIndex == start) return;
+
+	tempMove = moveList->moves[start];
+	moveList->moves[start] = moveList->moves[bestIndex];
+	moveList->moves[bestIndex] = tempMove;
+
+	tempScore = scores[start];
+	scores[start] = scores[bestIndex];
+	scores[bestIndex] = tempScore;
+}
+
+/*
+Remembers a quiet move that caused a cutoff, as a killer move of the ply and in the history table.
+*/
+static void minimaxUpdateQuietCutoff(MinimaxSearch * search, GameMove move, int depth, int ply) {
+	if (search->killers[ply][0] != move) {
+		search->killers[ply][1] = search->killers[ply][0];
+		search->killers[ply][0] = move;
 	}
 
-	return 0;
+	if (search->history[GAME_MOVE_FROM(move)][GAME_MOVE_TO(move)] < MINIMAX_ORDER_HISTORY_MAX) {
+		search->history[GAME_MOVE_FROM(move)][GAME_MOVE_TO(move)] += depth * depth;
+	}
 }
 
-static int minimaxScoringFunction(ChessBoard gameBoard, ChessPlayer positivePlayer) {
-	char currentPiece;
-	int whiteScore = 0, blackScore = 0;
+/*
+Returns the most that the capture can change the static score by: the captured material, plus a positional
+gain of MINIMAX_DELTA_MARGIN. The quiescence search limits the value of a capture to the static score plus
+this gain, so a capture that can't reach the window is skipped (delta pruning) without changing the value
+of the node: the value of a node doesn't depend on the window it's searched with.
+*/
+static int minimaxGetCaptureMaxGain(Game * game, GameMove move) {
+	BoardSquare destination = gameMoveGetDestination(move);
 
-	for (int i = 0; i < BOARD_ROWS_NUMBER; i++) {
-		for (int j = 0; j < BOARD_COLUMNS_NUMBER; j++) {
-			currentPiece = gameBoard[i][j];
+	return gameGetPieceValue(game->gameBoard[destination.row][destination.col]) * EVALUATION_PAWN_VALUE +
+		MINIMAX_DELTA_MARGIN;
+}
 
-			if (isupper(currentPiece)) blackScore += minimaxGetAbsuloteScoreOfPiece(currentPiece);
-			else if (islower(currentPiece)) whiteScore += minimaxGetAbsuloteScoreOfPiece(currentPiece);
+/*
+Quiescence search: extends a leaf of the alphabeta search with captures only, until the position is quiet,
+so that the static score is not taken in the middle of an exchange.
+The current player may "stand pat" - take the static score instead of capturing - unless it's checked,
+in which case all the moves are searched. The value of a capture is limited to the static score plus
+its maximal gain (see minimaxGetCaptureMaxGain), and captures that can't reach the window by it are
+skipped (delta pruning).
+A checked player without a valid move is mated. A player that isn't checked is checked for a stalemate before
+the stand pat (by gameCurrentPlayerHasValidMoves, which is cheap), so the value doesn't depend on the window.
+The search stops at minimaxQuiescenceMaxPly captures, or when the undo stack of the game is full.
+If the search is aborted, the game is restored and the returned value is meaningless.
+*/
+static int minimaxQuiescence(MinimaxSearch * search, Game * game, int ply, int quiescencePly, int alpha, int beta,
+	bool maximizingPlayer) {
+	MoveList moveList;
+	int scores[GAME_MAX_MOVES_NUMBER];
+	int value, nextValue, standPat, maxValue;
+	bool isChecked = gameIsCurrentPlayerChecked(game), hasValidMove = false;
+
+	search->stats.quiescenceNodes++;
+	if (ply > search->stats.maxPly) search->stats.maxPly = ply;
+	if (minimaxShouldAbort(search)) return 0;
+
+	standPat = minimaxScoringFunction(game, maximizingPlayer ? gameGetCurrentPlayer(game) : gameGetOtherPlayer(game));
+
+	if (quiescencePly >= minimaxQuiescenceMaxPly || ply >= MINIMAX_MAX_PLY || gameIsUndoStackFull(game)) {
+		// gameCheckWinner stops at the first valid move
+		if (isChecked && gameCheckWinner(game) != GAME_CHECK_WINNER_CONTINUE) {
+			return minimaxGetGameOverValue(game, ply, maximizingPlayer);
 		}
+
+		return standPat;
+	}
+
+	// a stalemate - a checked player searches all the moves, so a mate is found by the search
+	if (!isChecked && !gameCurrentPlayerHasValidMoves(game)) return minimaxGetGameOverValue(game, ply, maximizingPlayer);
+
+	if (isChecked) value = maximizingPlayer ? INT_MIN : INT_MAX;
+	else {
+		value = standPat;
+
+		if (maximizingPlayer && value >= beta) return value;
+		if (!maximizingPlayer && value <= alpha) return value;
+
+		if (maximizingPlayer && value > alpha) alpha = value;
+		if (!maximizingPlayer && value < beta) beta = value;
+	}
+
+	gameGeneratePseudoLegalMoves(game, &moveList);
+
+	for (int i = 0; i < moveList.size; i++) {
+		scores[i] = minimaxGetMoveOrderScore(search, game, moveList.moves[i], 0, ply);
 	}
 
-	if (positivePlayer == White) return whiteScore - blackScore;
-	return blackScore - whiteScore;
+	for (int i = 0; i < moveList.size; i++) {
+		minimaxSelectNextMove(&moveList, scores, i);
+		maxValue = maximizingPlayer ? INT_MAX : INT_MIN;
+
+		if (!isChecked) {
+			// the captures come first, so there are no more captures
+			if (!(GAME_MOVE_FLAGS(moveList.moves[i]) & GAME_MOVE_FLAG_CAPTURE)) break;
+
+			maxValue = standPat + (maximizingPlayer ? 1 : -1) * minimaxGetCaptureMaxGain(game, moveList.moves[i]);
+
+			// delta pruning. The limited value of the capture is a bound of its value, so it's taken as it is
+			if ((maximizingPlayer && maxValue <= alpha) || (!maximizingPlayer && maxValue >= beta)) {
+				if (maximizingPlayer && maxValue > value) value = maxValue;
+				if (!maximizingPlayer && maxValue < value) value = maxValue;
+				continue;
+			}
+		}
+
+		gameMakeMove(game, moveList.moves[i]);
+
+		if (gameIsOtherPlayerChecked(game)) {
+			gameUnmakeMove(game);
+			continue;
+		}
+
+		hasValidMove = true;
+		nextValue = minimaxQuiescence(search, game, ply + 1, quiescencePly + 1, alpha, beta, !maximizingPlayer);
+		gameUnmakeMove(game);
+
+		if (search->aborted) return value;
+
+		if (maximizingPlayer && nextValue > maxValue) nextValue = maxValue;
+		if (!maximizingPlayer && nextValue < maxValue) nextValue = maxValue;
+
+		if (maximizingPlayer && nextValue > value) value = nextValue;
+		if (!maximizingPlayer && nextValue < value) value = nextValue;
+
+		if (maximizingPlayer && value > alpha) alpha = value;
+		if (!maximizingPlayer && value < beta) beta = value;
+
+		if (beta <= alpha) break;
+	}
+
+	// a mate
+	if (isChecked && !hasValidMove) return minimaxGetGameOverValue(game, ply, maximizingPlayer);
+
+	return value;
 }
 
 /*
-Implementation of the alphabeta pruning minimax algorithm.
+Implementation of the alphabeta pruning minimax algorithm, with a transposition table.
 See more at https://en.wikipedia.org/wiki/Alpha%E2%80%93beta_pruning
+If the search is aborted, the game is restored and the returned value is meaningless.
 */
-static MoveAndValue minimaxAlphabetaPruning(Game * game, int depth, int alpha, int beta, bool maximizingPlayer) {
-	GAME_CHECK_WINNER_MESSAGE checkWinnerMsg = gameCheckWinner(game);
-	MovesBoardWithTypes movesBoardWithTypes = { {BoardSquareInvalidMove} };
+static MoveAndValue minimaxAlphabetaPruning(MinimaxSearch * search, Game * game, int depth, int ply, int alpha,
+	int beta, bool maximizingPlayer) {
+	MoveList moveList;
+	int scores[GAME_MAX_MOVES_NUMBER];
 	BoardSquare currentSquare, destSquare;
 	MoveAndValue currentMV = { .value = -1 }, nextMV;
+	GameMove bestMove = 0, hashMove;
+	int originalAlpha = alpha, originalBeta = beta, searchedMovesNumber = 0;
+	bool hasValidMove = false;
+
+	// a leaf - the value is given by the quiescence search (which also checks if the game has ended).
+	// In this case, the move itself doesn't matter - as the move will always be updated in the parent "virtual node".
+	// A full undo stack has no room for more moves, so the node is a leaf too
+	if (depth == 0 || gameIsUndoStackFull(game)) {
+		search->stats.leafNodes++;
+		currentMV.value = minimaxQuiescence(search, game, ply, 0, alpha, beta, maximizingPlayer);
+		return currentMV;
+	}
 
-	// check if game has ended. In this case, the move itself doesn't matter
-	// - as the move will always be updated in the parent "virtual node"
-	if (checkWinnerMsg == GAME_CHECK_WINNER_CURRENT_PLAYER_LOSE) {
-		if (maximizingPlayer) currentMV.value = -1000;
-		else currentMV.value = 1000;
+	search->stats.nodes++;
+	if (minimaxShouldAbort(search)) return currentMV;
 
+	// this position has already been searched (possibly through a different move order)
+	if (minimaxProbeTranspositionTable(search, game, depth, ply, alpha, beta, maximizingPlayer, &currentMV, &hashMove)) {
 		return currentMV;
 	}
-	if (checkWinnerMsg == GAME_CHECK_WINNER_DRAW) {
-		currentMV.value = 0;
-		return currentMV;
+
+	currentMV.value = maximizingPlayer ? INT_MIN : INT_MAX;
+
+	// all the moves of the current player, including moves that leave the king threatened
+	gameGeneratePseudoLegalMoves(game, &moveList);
+
+	for (int i = 0; i < moveList.size; i++) {
+		scores[i] = minimaxGetMoveOrderScore(search, game, moveList.moves[i], hashMove, ply);
 	}
 
-	if (depth == 0) {
-		currentMV.value = minimaxScoringFunction(game->gameBoard, maximizingPlayer ? gameGetCurrentPlayer(game) : gameGetOtherPlayer(game));
-		return currentMV;
+	for (int i = 0; i < moveList.size; i++) {
+		// the moves are sorted lazily - a cutoff usually happens after a few moves
+		minimaxSelectNextMove(&moveList, scores, i);
+		currentSquare = gameMoveGetSource(moveList.moves[i]);
+		destSquare = gameMoveGetDestination(moveList.moves[i]);
+
+		// move, check value and undo move
+
+		// we use gameMakeMove for optimization: 
+		// all the checks that are made in gameSetMove are performed here
+		gameMakeMove(game, moveList.moves[i]);
+
+		// the move is not valid if it leaves the king of the player threatened
+		if (gameIsOtherPlayerChecked(game)) {
+			gameUnmakeMove(game);
+			continue;
+		}
+
+		hasValidMove = true;
+		searchedMovesNumber++;
+		nextMV = minimaxAlphabetaPruning(search, game, depth - 1, ply + 1, alpha, beta, !maximizingPlayer);
+		gameUnmakeMove(game);
+
+		if (search->aborted) return currentMV;
+
+		// take the maximum / minimum
+		if ((maximizingPlayer && nextMV.value > currentMV.value) ||
+			(!maximizingPlayer && nextMV.value < currentMV.value)) {
+			currentMV.value = nextMV.value;
+			currentMV.move.oldSquare = currentSquare;
+			currentMV.move.newSquare = destSquare;
+			bestMove = moveList.moves[i];
+		}
+
+		if (maximizingPlayer && currentMV.value > alpha) alpha = currentMV.value;
+		if (!maximizingPlayer && currentMV.value < beta) beta = currentMV.value;
+
+		if (beta <= alpha) {
+			search->stats.betaCutoffs++;
+			if (searchedMovesNumber == 1) search->stats.firstMoveCutoffs++;
+
+			if (!(GAME_MOVE_FLAGS(moveList.moves[i]) & GAME_MOVE_FLAG_CAPTURE) && ply < MINIMAX_MAX_PLY) {
+				minimaxUpdateQuietCutoff(search, moveList.moves[i], depth, ply);
+			}
+			break;
+		}
+	}
+
+	// no valid moves - the game has ended in this node
+	if (!hasValidMove) currentMV.value = minimaxGetGameOverValue(game, ply, maximizingPlayer);
+
+	minimaxStoreInTranspositionTable(search, game, depth, ply, originalAlpha, originalBeta, maximizingPlayer,
+		currentMV.value, bestMove);
+
+	return currentMV;
+}
+
+/*
+The shared state of a root split search: the root moves are searched in parallel, and each value
+that is found raises the alpha of the moves that are searched after it.
+*/
+typedef struct minimax_root_split_t {
+	Game * game; // the root position
+	MoveList moves; // the valid root moves, in the order of the serial search
+	int values[GAME_MAX_MOVES_NUMBER]; // the value of each move, exact if it's at least the final alpha
+	int depth;
+	int alpha; // the best value so far. Accessed atomically
+	int nextMoveIndex; // the index of the next move to search. Accessed atomically
+} MinimaxRootSplit;
+
+/*
+A worker of a root split search, with its own copy of the game.
+*/
+typedef struct minimax_worker_t {
+	MinimaxRootSplit * split;
+	Game * game;
+	MinimaxSearch * search;
+	MinimaxSearch ownSearch; // the search of a helper thread (the main thread uses the original search)
+	pthread_t thread;
+	bool isRunning;
+} MinimaxWorker;
+
+/*
+Returns a copy of the game for a helper thread, from the game pool (which is created on the first use).
+Returns NULL if the copy can't be created.
+*/
+static Game * minimaxAcquireGameCopy(Game * game) {
+	if (minimaxGamePool == NULL) minimaxGamePool = gamePoolCreate(MINIMAX_MAX_THREADS_NUMBER - 1);
+	if (minimaxGamePool == NULL) return NULL;
+
+	return gamePoolAcquireCopy(minimaxGamePool, game);
+}
+
+/*
+Adds the counters of the stats of a helper thread to the stats of the search.
+*/
+static void minimaxAddStats(MinimaxStats * stats, MinimaxStats * helperStats) {
+	stats->nodes += helperStats->nodes;
+	stats->quiescenceNodes += helperStats->quiescenceNodes;
+	stats->leafNodes += helperStats->leafNodes;
+	stats->betaCutoffs += helperStats->betaCutoffs;
+	stats->firstMoveCutoffs += helperStats->firstMoveCutoffs;
+	stats->tableProbes += helperStats->tableProbes;
+	stats->tableHits += helperStats->tableHits;
+	if (helperStats->maxPly > stats->maxPly) stats->maxPly = helperStats->maxPly;
+}
+
+/*
+Atomically sets *target to value if value is larger.
+*/
+static void minimaxAtomicMax(int * target, int value) {
+	int current = __atomic_load_n(target, __ATOMIC_RELAXED);
+
+	while (value > current &&
+		!__atomic_compare_exchange_n(target, &current, value, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
 	}
+}
 
-	if (maximizingPlayer) {
-		currentMV.value = INT_MIN;
+/*
+Takes root moves of the split one by one and searches them, until there are no more moves
+or the search is aborted.
+*/
+static void minimaxSearchRootMoves(MinimaxWorker * worker) {
+	MinimaxRootSplit * split = worker->split;
+	GameMove move;
+	int index, alpha, value;
 
-		// go over the pieces
-		for (int j = 0; j < BOARD_COLUMNS_NUMBER; j++) {
-			for (int i = 0; i < BOARD_ROWS_NUMBER; i++) {
-				currentSquare = (BoardSquare) { i, j };
+	while ((index = __atomic_fetch_add(&split->nextMoveIndex, 1, __ATOMIC_RELAXED)) < split->moves.size) {
+		move = split->moves.moves[index];
+		alpha = __atomic_load_n(&split->alpha, __ATOMIC_RELAXED);
 
-				// if current player piece - check the moves
-				if (gameIsPieceOfCurrentPlayer(game, currentSquare)) {
-					gameGetMovesWrapper(game, currentSquare, movesBoardWithTypes);
+		// the window starts one below alpha, so a move that is as good as the best move gets its exact value
+		gameMakeMove(worker->game, move);
+		value = minimaxAlphabetaPruning(worker->search, worker->game, split->depth - 1, 1,
+			alpha == INT_MIN ? INT_MIN : alpha - 1, INT_MAX, false).value;
+		gameUnmakeMove(worker->game);
 
-					for (int l = 0; l < BOARD_COLUMNS_NUMBER; l++) {
-						for (int k = 0; k < BOARD_ROWS_NUMBER; k++) {
+		if (worker->search->aborted) return;
+
+		split->values[index] = value;
+		minimaxAtomicMax(&split->alpha, value);
+	}
+}
+
+static void * minimaxWorkerThread(void * arg) {
+	minimaxSearchRootMoves((MinimaxWorker *)arg);
+
+	return NULL;
+}
 
-							// check if move is valid
-							if (gameIsValidMove(movesBoardWithTypes[k][l])) {
-								destSquare = (BoardSquare) { k, l };
+/*
+Fills rootMoves with the valid moves of the root, in the order that the serial search tries them.
+*/
+static void minimaxGetOrderedRootMoves(MinimaxSearch * search, Game * game, GameMove hashMove, MoveList * rootMoves) {
+	MoveList moveList;
+	int scores[GAME_MAX_MOVES_NUMBER];
 
-								// move, check value and undo move
+	gameGeneratePseudoLegalMoves(game, &moveList);
 
-								// we use gameForceSetMove for optimization: 
-								// all the checks that are made in gameSetMove are performed here
-								gameForceSetMove(game, currentSquare, destSquare);
+	for (int i = 0; i < moveList.size; i++) {
+		scores[i] = minimaxGetMoveOrderScore(search, game, moveList.moves[i], hashMove, 0);
+	}
 
-								// take the maximum
-								nextMV = minimaxAlphabetaPruning(game, depth - 1, alpha, beta, false);
-								if (nextMV.value > currentMV.value) {
-									currentMV.value = nextMV.value;
-									currentMV.move.oldSquare = currentSquare;
-									currentMV.move.newSquare = destSquare;
-								}
+	rootMoves->size = 0;
 
-								gameUndoPrevMove(game);
+	for (int i = 0; i < moveList.size; i++) {
+		minimaxSelectNextMove(&moveList, scores, i);
 
-								if (currentMV.value > alpha) alpha = currentMV.value;
+		gameMakeMove(game, moveList.moves[i]);
+		if (!gameIsOtherPlayerChecked(game)) rootMoves->moves[rootMoves->size++] = moveList.moves[i];
+		gameUnmakeMove(game);
+	}
+}
 
-								if (beta <= alpha) return currentMV;
-							}
-						}
-					}
-				}
-			}
+/*
+Searches the root moves of the split in parallel, with up to minimaxThreadsNumber threads. The first move
+is searched by the calling thread alone, and then every thread (the calling thread too) takes the next move
+that hasn't been searched, with the shared alpha. Each helper thread searches its own copy of the game,
+and stores its results in a private transposition table, so only the calling thread writes to the shared table.
+If a copy, a table or a thread can't be created, the search goes on with less threads.
+The value of a node depends only on the position and the depth, and not on the window, the move order or the
+results in the tables (see minimaxQuiescence and minimaxProbeTranspositionTable). So every move that is at
+least as good as the best move gets its exact value, and the returned move is the first move (in the serial
+order) that has the best value - the move of the serial search.
+Assumes there are at least two valid moves.
+*/
+static MoveAndValue minimaxRootSplitSearch(MinimaxSearch * search, MinimaxRootSplit * split) {
+	MinimaxWorker * workers;
+	MinimaxWorker mainWorker = { .split = split, .game = split->game, .search = search, .isRunning = false };
+	MoveAndValue mv = { .value = -1 };
+	GameMove bestMove;
+	int helpersNumber = minimaxThreadsNumber - 1, bestIndex = 0, tableSizeMB;
+
+	if (helpersNumber > split->moves.size - 2) helpersNumber = split->moves.size - 2;
+
+	// the private tables of the helpers together take the size of the shared table
+	tableSizeMB = helpersNumber > 0 ? minimaxTableSizeMB / helpersNumber : 0;
+	if (tableSizeMB < 1) tableSizeMB = 1;
+
+	// the first move is searched alone - it's usually the best, and gives a good alpha for all the others
+	gameMakeMove(split->game, split->moves.moves[0]);
+	split->values[0] = minimaxAlphabetaPruning(search, split->game, split->depth - 1, 1, INT_MIN, INT_MAX, false).value;
+	gameUnmakeMove(split->game);
+
+	if (search->aborted) return mv;
+
+	split->alpha = split->values[0];
+	split->nextMoveIndex = 1;
+
+	workers = helpersNumber > 0 ? malloc(sizeof(MinimaxWorker) * helpersNumber) : NULL;
+	if (workers == NULL) helpersNumber = 0;
+
+	for (int i = 0; i < helpersNumber; i++) {
+		workers[i].split = split;
+		workers[i].search = &workers[i].ownSearch;
+		workers[i].ownSearch = *search; // the same deadline and move ordering tables
+		workers[i].ownSearch.stats = (MinimaxStats) { 0 };
+		workers[i].ownSearch.privateTable = minimaxTable != NULL ? transpositionTableCreate(tableSizeMB) : NULL;
+		workers[i].game = minimaxAcquireGameCopy(split->game);
+		workers[i].isRunning = workers[i].game != NULL &&
+			(minimaxTable == NULL || workers[i].ownSearch.privateTable != NULL) &&
+			pthread_create(&workers[i].thread, NULL, minimaxWorkerThread, &workers[i]) == 0;
+	}
+
+	minimaxSearchRootMoves(&mainWorker);
+
+	for (int i = 0; i < helpersNumber; i++) {
+		if (workers[i].isRunning) {
+			pthread_join(workers[i].thread, NULL);
+
+			minimaxAddStats(&search->stats, &workers[i].ownSearch.stats);
+			if (workers[i].ownSearch.aborted) search->aborted = true;
 		}
 
-		return currentMV;
+		gamePoolRelease(minimaxGamePool, workers[i].game);
+		transpositionTableDestroy(workers[i].ownSearch.privateTable);
+	}
+
+	free(workers);
+
+	if (search->aborted) return mv;
+
+	// the first move with the best value. The values below the final alpha are only upper bounds
+	for (int i = 1; i < split->moves.size; i++) {
+		if (split->values[i] > split->values[bestIndex]) bestIndex = i;
+	}
+
+	bestMove = split->moves.moves[bestIndex];
+	mv.value = split->values[bestIndex];
+	mv.move = minimaxGetMove(bestMove);
+
+	minimaxStoreInTranspositionTable(search, split->game, split->depth, 0, INT_MIN, INT_MAX, true, mv.value, bestMove);
+
+	return mv;
+}
+
+/*
+A helper thread of a Lazy SMP search.
+*/
+typedef struct minimax_helper_t {
+	Game * game; // a copy of the root position
+	MinimaxSearch search;
+	int depth; // the depth of the main search
+	int index; // the index of the helper, from 0
+	pthread_t thread;
+	bool isRunning;
+} MinimaxHelper;
+
+/*
+The work of a Lazy SMP helper: iterative deepening of the root up to one ply deeper than the main search.
+Every other helper starts one ply deeper, so the helpers don't search the same depths at the same time.
+The results are only used through the shared transposition table.
+*/
+static void * minimaxHelperThread(void * arg) {
+	MinimaxHelper * helper = (MinimaxHelper *)arg;
+
+	for (int depth = 1 + helper->index % 2; depth <= helper->depth + 1; depth++) {
+		minimaxAlphabetaPruning(&helper->search, helper->game, depth, 0, INT_MIN, INT_MAX, true);
+		if (helper->search.aborted) break;
+	}
+
+	return NULL;
+}
+
+/*
+Lazy SMP: minimaxThreadsNumber - 1 helper threads search the same root (each with its own copy of the game)
+and fill the shared transposition table, while the calling thread runs the serial search. The helpers are
+stopped when the serial search ends, and its result is returned.
+If a copy or a thread can't be created, the search goes on with less threads.
+*/
+static MoveAndValue minimaxLazySmpSearch(MinimaxSearch * search, Game * game, int depth) {
+	MinimaxHelper * helpers;
+	MoveAndValue mv;
+	int helpersNumber = minimaxThreadsNumber - 1, stop = 0;
+
+	helpers = malloc(sizeof(MinimaxHelper) * helpersNumber);
+	if (helpers == NULL) return minimaxAlphabetaPruning(search, game, depth, 0, INT_MIN, INT_MAX, true);
+
+	for (int i = 0; i < helpersNumber; i++) {
+		helpers[i].search = *search; // the same deadline and move ordering tables
+		helpers[i].search.stats = (MinimaxStats) { 0 };
+		helpers[i].search.stop = &stop;
+		helpers[i].depth = depth;
+		helpers[i].index = i;
+		helpers[i].game = minimaxAcquireGameCopy(game);
+		helpers[i].isRunning = helpers[i].game != NULL &&
+			pthread_create(&helpers[i].thread, NULL, minimaxHelperThread, &helpers[i]) == 0;
+	}
+
+	mv = minimaxAlphabetaPruning(search, game, depth, 0, INT_MIN, INT_MAX, true);
+
+	__atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+
+	for (int i = 0; i < helpersNumber; i++) {
+		if (helpers[i].isRunning) {
+			pthread_join(helpers[i].thread, NULL);
+
+			minimaxAddStats(&search->stats, &helpers[i].search.stats);
+		}
+
+		gamePoolRelease(minimaxGamePool, helpers[i].game);
+	}
+
+	free(helpers);
+
+	return mv;
+}
+
+/*
+Searches the root of the game to the given depth: in parallel if there's more than one thread (by the
+parallel mode), and otherwise with minimaxAlphabetaPruning.
+*/
+static MoveAndValue minimaxSearchRoot(MinimaxSearch * search, Game * game, int depth) {
+	MinimaxRootSplit * split;
+	MoveAndValue mv;
+	GameMove hashMove;
+
+	if (minimaxThreadsNumber <= 1 || depth < 2) {
+		return minimaxAlphabetaPruning(search, game, depth, 0, INT_MIN, INT_MAX, true);
+	}
+
+	if (minimaxParallelMode == MinimaxParallelLazySmp) return minimaxLazySmpSearch(search, game, depth);
+
+	// root split
+
+	// the root is probed as in the serial search
+	if (minimaxProbeTranspositionTable(search, game, depth, 0, INT_MIN, INT_MAX, true, &mv, &hashMove)) {
+		search->stats.nodes++;
+		return mv;
+	}
+
+	split = malloc(sizeof(MinimaxRootSplit));
+	if (split != NULL) {
+		split->game = game;
+		split->depth = depth;
+		minimaxGetOrderedRootMoves(search, game, hashMove, &split->moves);
 	}
 
+	if (split == NULL || split->moves.size < 2) mv = minimaxAlphabetaPruning(search, game, depth, 0, INT_MIN, INT_MAX, true);
 	else {
-		currentMV.value = INT_MAX;
+		search->stats.nodes++;
+		mv = minimaxRootSplitSearch(search, split);
+	}
+
+	free(split);
+
+	return mv;
+}
+
+bool minimaxSetTranspositionTableSize(int sizeMB) {
+	TranspositionTable * table = NULL;
+
+	if (sizeMB < 0) return false;
 
-		// go over the pieces
-		for (int j = 0; j < BOARD_COLUMNS_NUMBER; j++) {
-			for (int i = 0; i < BOARD_ROWS_NUMBER; i++) {
-				currentSquare = (BoardSquare) { i, j };
+	if (sizeMB > 0) {
+		table = transpositionTableCreate(sizeMB);
+		if (table == NULL) return false;
+	}
+
+	transpositionTableDestroy(minimaxTable);
+	minimaxTable = table;
+	minimaxTableSizeMB = sizeMB;
+
+	return true;
+}
+
+bool minimaxSetQuiescenceMaxPly(int maxPly) {
+	if (maxPly < 0 || maxPly > MINIMAX_QUIESCENCE_MAX_PLY_LIMIT) return false;
+
+	minimaxQuiescenceMaxPly = maxPly;
+
+	return true;
+}
+
+bool minimaxSetThreadsNumber(int threadsNumber) {
+	if (threadsNumber < 1 || threadsNumber > MINIMAX_MAX_THREADS_NUMBER) return false;
 
-				// if current player piece - check the moves
-				if (gameIsPieceOfCurrentPlayer(game, currentSquare)) {
-					gameGetMovesWrapper(game, currentSquare, movesBoardWithTypes);
+	minimaxThreadsNumber = threadsNumber;
 
-					for (int l = 0; l < BOARD_COLUMNS_NUMBER; l++) {
-						for (int k = 0; k < BOARD_ROWS_NUMBER; k++) {
+	return true;
+}
 
-							// check if move is valid
-							if (gameIsValidMove(movesBoardWithTypes[k][l])) {
-								destSquare = (BoardSquare) { k, l };
+void minimaxSetParallelMode(MinimaxParallelMode mode) {
+	minimaxParallelMode = mode;
+}
 
-								// we use gameForceSetMove for optimization: 
-								// all the checks that are made in gameSetMove are performed here
-								gameForceSetMove(game, currentSquare, destSquare);
+MinimaxStats minimaxGetLastSearchStats() {
+	return minimaxLastStats;
+}
 
-								// take the minimum
-								nextMV = minimaxAlphabetaPruning(game, depth - 1, alpha, beta, true);
-								if (nextMV.value < currentMV.value) {
-									currentMV.value = nextMV.value;
-									currentMV.move.oldSquare = currentSquare;
-									currentMV.move.newSquare = destSquare;
-								}
+void minimaxDestroyTranspositionTable() {
+	transpositionTableDestroy(minimaxTable);
+	minimaxTable = NULL;
+}
 
-								gameUndoPrevMove(game);
+void minimaxClearTranspositionTable() {
+	if (minimaxTable == NULL && minimaxTableSizeMB > 0) minimaxSetTranspositionTableSize(minimaxTableSizeMB);
 
-								if (currentMV.value < beta) beta = currentMV.value;
+	// a new table is cleared too, so its memory is touched now and not by the next search
+	if (minimaxTable != NULL) transpositionTableClear(minimaxTable);
+}
 
-								if (beta <= alpha) return currentMV;
-							}
-						}
-					}
-				}
+void minimaxFreeResources() {
+	minimaxDestroyTranspositionTable();
+
+	gamePoolDestroy(minimaxGamePool);
+	minimaxGamePool = NULL;
+}
+
+/*
+Prepares the transposition table for a new search.
+The table is created on the first search (if it's not disabled).
+*/
+static void minimaxPrepareTranspositionTable() {
+	if (minimaxTable == NULL && minimaxTableSizeMB > 0) minimaxSetTranspositionTableSize(minimaxTableSizeMB);
+	if (minimaxTable != NULL) transpositionTableNewSearch(minimaxTable);
+}
+
+/*
+Records a completed iteration of the search in the stats.
+*/
+static void minimaxAddIterationStats(MinimaxStats * stats, int depth, long long timeMs) {
+	stats->depth = depth;
+
+	if (stats->iterationsNumber < MINIMAX_STATS_MAX_ITERATIONS) {
+		stats->iterationTimesMs[stats->iterationsNumber++] = timeMs;
+	}
+}
+
+/*
+Fills the best line of the stats: the chosen move, and then the best moves that are stored in the
+transposition table for the positions after it. A stored move is followed only if it's a valid move
+of the position, as a different position may share the entry. The game is restored.
+*/
+static void minimaxSetBestLine(MinimaxStats * stats, Game * game, Move rootMove) {
+	MoveList moveList;
+	TranspositionEntry entry;
+	GameMove move = 0, nextMove;
+
+	stats->bestLineLength = 0;
+
+	if (rootMove.oldSquare.row >= 0) {
+		move = GAME_MOVE_CREATE(BITBOARD_SQUARE_INDEX(rootMove.oldSquare.row, rootMove.oldSquare.col),
+			BITBOARD_SQUARE_INDEX(rootMove.newSquare.row, rootMove.newSquare.col), 0);
+	}
+
+	while (move != 0 && stats->bestLineLength < MINIMAX_STATS_MAX_LINE_LENGTH && !gameIsUndoStackFull(game)) {
+		gameGenerateMoves(game, &moveList);
+		nextMove = 0;
+
+		for (int i = 0; i < moveList.size && nextMove == 0; i++) {
+			if (GAME_MOVE_FROM(moveList.moves[i]) == GAME_MOVE_FROM(move) &&
+				GAME_MOVE_TO(moveList.moves[i]) == GAME_MOVE_TO(move)) {
+				nextMove = moveList.moves[i];
 			}
 		}
 
-		return currentMV;
+		if (nextMove == 0) break;
+
+		stats->bestLine[stats->bestLineLength++] = nextMove;
+		gameMakeMove(game, nextMove);
+
+		move = 0;
+		if (minimaxTable != NULL && transpositionTableProbe(minimaxTable, game->zobristKey, &entry)) {
+			move = entry.bestMove;
+		}
 	}
+
+	for (int i = 0; i < stats->bestLineLength; i++) gameUnmakeMove(game);
 }
 
 Move minimaxSuggestMove(Game * game, int level) {
-	return minimaxAlphabetaPruning(game, level, INT_MIN, INT_MAX, true).move;
-}
\ No newline at end of file
+	MinimaxSearch search = { .deadlineMs = 0, .stats = { 0 }, .aborted = false, .stop = NULL };
+	long long startMs = minimaxGetTimeMs();
+	MoveAndValue mv;
+
+	minimaxPrepareTranspositionTable();
+
+	mv = minimaxSearchRoot(&search, game, level);
+
+	search.stats.timeMs = minimaxGetTimeMs() - startMs;
+	minimaxAddIterationStats(&search.stats, level, search.stats.timeMs);
+	minimaxSetBestLine(&search.stats, game, mv.move);
+	minimaxLastStats = search.stats;
+
+	return mv.move;
+}
+
+Move minimaxSuggestMoveTimed(Game * game, int maxDepth, int budgetMs) {
+	MinimaxSearch search = { .deadlineMs = 0, .stats = { 0 }, .aborted = false, .stop = NULL };
+	long long startMs = minimaxGetTimeMs(), iterationStartMs, deadlineMs = startMs + budgetMs;
+	MoveAndValue mv;
+	Move bestMove = { { -1, -1 }, { -1, -1 } };
+
+	minimaxPrepareTranspositionTable();
+
+	for (int depth = 1; depth <= maxDepth; depth++) {
+		// the first iteration is always completed, so there is always a move to return
+		if (depth > 1 && budgetMs > 0) search.deadlineMs = deadlineMs;
+
+		iterationStartMs = minimaxGetTimeMs();
+		mv = minimaxSearchRoot(&search, game, depth);
+		if (search.aborted) break;
+
+		minimaxAddIterationStats(&search.stats, depth, minimaxGetTimeMs() - iterationStartMs);
+		bestMove = mv.move;
+	}
+
+	search.stats.timeMs = minimaxGetTimeMs() - startMs;
+	minimaxSetBestLine(&search.stats, game, bestMove);
+	minimaxLastStats = search.stats;
+
+	return bestMove;
+}
@@ -3,11 +3,23 @@
 
 #include <limits.h>
 #include "Game.h"
+#include "TranspositionTable.h"
+#include "GamePool.h"
 
 /*
 This module handle a move suggestion, using the minimax algorithm.
+Search results are kept in a transposition table that is shared by all the searches, so positions
+that are reached through different move orders (or again in the next move) are not searched again.
+The leaves of the search are extended by a quiescence search of captures.
+With more than one thread, each thread searches its own copy of the game: either the root moves are
+split between the threads, or (Lazy SMP) all the threads search the whole root and share their results
+through the transposition table.
 */
 
+#define MINIMAX_QUIESCENCE_DEFAULT_MAX_PLY 8
+#define MINIMAX_QUIESCENCE_MAX_PLY_LIMIT 16 // the undo stack of the game must have room for this number of extra moves
+#define MINIMAX_MAX_THREADS_NUMBER 64
+
 typedef struct move_t {
 	BoardSquare oldSquare;
 	BoardSquare newSquare;
@@ -18,6 +30,37 @@ typedef struct move_and_value_t {
 	int value;
 } MoveAndValue;
 
+/*
+The way that a search with more than one thread is parallelized.
+*/
+typedef enum minimax_parallel_mode_e {
+	MinimaxParallelRootSplit, // the same move as the serial search
+	MinimaxParallelLazySmp // scales better, but the move may depend on the timing of the threads
+} MinimaxParallelMode;
+
+#define MINIMAX_STATS_MAX_ITERATIONS 32 // the iterations (depths) whose times are kept
+#define MINIMAX_STATS_MAX_LINE_LENGTH 16 // the maximum length of the best line
+
+/*
+Statistics of a search. The counters of the helper threads of a parallel search are included.
+*/
+typedef struct minimax_stats_t {
+	long long nodes; // the nodes of the main search (leaves excluded)
+	long long quiescenceNodes; // the nodes of the quiescence search, including the leaves of the main search
+	long long leafNodes; // the leaves of the main search, each of them starts a quiescence search
+	long long betaCutoffs; // the nodes of the main search that were cut off
+	long long firstMoveCutoffs; // the cutoffs by the first move that was searched in the node
+	long long tableProbes; // transposition table lookups
+	long long tableHits; // transposition table lookups that found the position
+	int maxPly; // the deepest ply that was reached, quiescence search included
+	int depth; // the depth of the last completed iteration
+	int iterationsNumber; // the number of completed iterations
+	long long iterationTimesMs[MINIMAX_STATS_MAX_ITERATIONS]; // the time of each completed iteration
+	long long timeMs; // the time of the whole search
+	GameMove bestLine[MINIMAX_STATS_MAX_LINE_LENGTH]; // the expected moves from the root, by the table
+	int bestLineLength;
+} MinimaxStats;
+
 /*
 Suggest a move to the current player.
 @param level the game level (minimax depth)
@@ -27,4 +70,72 @@ the suggest move
 */
 Move minimaxSuggestMove(Game * game, int level);
 
+/*
+Suggest a move to the current player, using iterative deepening: searches to depth 1, 2, ...
+until maxDepth is reached or the time budget is over. The search that is running when the budget
+is over is aborted, and the move of the last completed search is returned.
+The search to depth 1 is always completed.
+@param game the game
+@param maxDepth the maximum depth (at least 1)
+@param budgetMs the time budget in milliseconds, or 0 for no time limit
+@return
+the suggested move
+*/
+Move minimaxSuggestMoveTimed(Game * game, int maxDepth, int budgetMs);
+
+/*
+Sets the size of the transposition table, and clears it.
+The default size is TRANSPOSITION_TABLE_DEFAULT_SIZE_MB. A root split search with more than one thread
+takes up to twice the size, for the private tables of the helper threads.
+@param sizeMB the size in megabytes, or 0 to disable the table
+@return true iff the table has been set (on failure, the previous table is kept)
+*/
+bool minimaxSetTranspositionTableSize(int sizeMB);
+
+/*
+Sets the maximum number of plies of the quiescence search. The default is MINIMAX_QUIESCENCE_DEFAULT_MAX_PLY.
+@param maxPly the maximum number of plies, or 0 to use the static score at the leaves
+@return true iff maxPly is between 0 and MINIMAX_QUIESCENCE_MAX_PLY_LIMIT (otherwise nothing is changed)
+*/
+bool minimaxSetQuiescenceMaxPly(int maxPly);
+
+/*
+Sets the number of threads of the next searches (1 by default). With MinimaxParallelRootSplit mode,
+the suggested move doesn't depend on the number of threads.
+@param threadsNumber the number of threads, including the calling thread
+@return true iff threadsNumber is between 1 and MINIMAX_MAX_THREADS_NUMBER (otherwise nothing is changed)
+*/
+bool minimaxSetThreadsNumber(int threadsNumber);
+
+/*
+Sets the parallel mode of the next searches with more than one thread (MinimaxParallelRootSplit by default).
+@param mode the parallel mode
+*/
+void minimaxSetParallelMode(MinimaxParallelMode mode);
+
+/*
+Returns the statistics of the last search (of an aborted search too).
+The best line starts with the suggested move, and is followed in the transposition table as long as
+the stored moves are valid (so it's empty if the table is disabled, except for the suggested move).
+*/
+MinimaxStats minimaxGetLastSearchStats();
+
+/*
+Frees the transposition table. It will be created again on the next search.
+*/
+void minimaxDestroyTranspositionTable();
+
+/*
+Clears the transposition table (and creates it if it was freed), so the next search doesn't depend
+on the earlier searches.
+*/
+void minimaxClearTranspositionTable();
+
+/*
+Frees all the memory of the module: the transposition table and the copies of the game that are kept
+for the helper threads. They will be created again on the next search.
+Should be called before the program exits.
+*/
+void minimaxFreeResources();
+
 #endif
\ No newline at end of file
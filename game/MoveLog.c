@@ -0,0 +1,126 @@
+#define _POSIX_C_SOURCE 200809L // for clock_gettime
+#include "MoveLog.h"
+#include <time.h>
+
+/*
+Returns the time in milliseconds from an arbitrary starting point (a monotonic clock).
+*/
+static long long moveLogGetTimeMs() {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+MoveLog * moveLogCreate() {
+	MoveLog * log = malloc(sizeof(MoveLog));
+	if (log == NULL) return NULL;
+
+	log->first = NULL;
+	log->last = NULL;
+	log->size = 0;
+	log->startTimeMs = moveLogGetTimeMs();
+
+	return log;
+}
+
+void moveLogDestroy(MoveLog * log) {
+	MoveLogChunk * chunk, * next;
+
+	if (log == NULL) return;
+
+	for (chunk = log->first; chunk != NULL; chunk = next) {
+		next = chunk->next;
+		free(chunk);
+	}
+
+	free(log);
+}
+
+MOVE_LOG_MESSAGE moveLogAppend(MoveLog * log, MoveLogEntry entry) {
+	MoveLogChunk * chunk;
+
+	if (log == NULL) return MOVE_LOG_INVALID_ARGUMENT;
+
+	// the last chunk is full (or there are no chunks yet)
+	if (log->size % MOVE_LOG_CHUNK_SIZE == 0) {
+		chunk = malloc(sizeof(MoveLogChunk));
+		if (chunk == NULL) return MOVE_LOG_ALLOCATION_FAILED;
+
+		chunk->next = NULL;
+
+		if (log->last == NULL) log->first = chunk;
+		else log->last->next = chunk;
+
+		log->last = chunk;
+	}
+
+	entry.timeMs = moveLogGetElapsedMs(log);
+	log->last->entries[log->size % MOVE_LOG_CHUNK_SIZE] = entry;
+	log->size++;
+
+	return MOVE_LOG_SUCCESS;
+}
+
+int moveLogSize(MoveLog * log) {
+	if (log == NULL) return -1;
+
+	return log->size;
+}
+
+MoveLogEntry moveLogGetAt(MoveLog * log, int index) {
+	MoveLogChunk * chunk;
+
+	if (log == NULL || index < 0 || index >= log->size) return (MoveLogEntry) { .from = { -1, -1 } };
+
+	chunk = log->first;
+	for (int i = 0; i < index / MOVE_LOG_CHUNK_SIZE; i++) chunk = chunk->next;
+
+	return chunk->entries[index % MOVE_LOG_CHUNK_SIZE];
+}
+
+void moveLogForEach(MoveLog * log, void (*func)(MoveLogEntry * entry, int index, void * context), void * context) {
+	MoveLogChunk * chunk;
+
+	if (log == NULL) return;
+
+	chunk = log->first;
+	for (int i = 0; i < log->size; i++) {
+		if (i > 0 && i % MOVE_LOG_CHUNK_SIZE == 0) chunk = chunk->next;
+
+		func(&chunk->entries[i % MOVE_LOG_CHUNK_SIZE], i, context);
+	}
+}
+
+long long moveLogGetElapsedMs(MoveLog * log) {
+	return moveLogGetTimeMs() - log->startTimeMs;
+}
+
+/*
+Prints an entry as a line of the log file. The context is the file handler.
+*/
+static void moveLogPrintEntry(MoveLogEntry * entry, int index, void * context) {
+	FILE * fh = context;
+	char * type = "move";
+
+	if (entry->type == MoveLogEntryComputerMove) type = "computer move";
+	if (entry->type == MoveLogEntryUndo) type = "undo";
+
+	fprintf(fh, "%d. [%lldms] %s %s: %c <%d,%c> -> <%d,%c>", index + 1, entry->timeMs,
+		entry->player == White ? "white" : "black", type, entry->piece,
+		entry->from.row + 1, entry->from.col + 'A', entry->to.row + 1, entry->to.col + 'A');
+
+	if (entry->capturedPiece != BOARD_EMPTY_CELL) fprintf(fh, " captures %c", entry->capturedPiece);
+
+	if (entry->type == MoveLogEntryComputerMove) {
+		fprintf(fh, " (search: %lldms, %lld nodes, %lld quiescence nodes)", entry->searchTimeMs,
+			entry->searchStats.nodes, entry->searchStats.quiescenceNodes);
+	}
+
+	fprintf(fh, "\n");
+}
+
+void moveLogPrintToFileHandler(FILE * fh, MoveLog * log) {
+	moveLogForEach(log, moveLogPrintEntry, fh);
+}
@@ -0,0 +1,123 @@
+#ifndef MOVE_LOG_H_
+#define MOVE_LOG_H_
+
+#include "Minimax.h"
+
+/*
+MoveLog Summary:
+An append-only log of everything that was played in a game: the moves of the users and of the computer
+(with the statistics of the search that chose it), and the undo operations. Unlike the game history,
+which keeps only the last moves for undo, the log is never trimmed, so a whole game can be replayed,
+analyzed or exported.
+
+The entries are stored in fixed-size chunks that are allocated as the log grows, so an append takes
+constant time, and only one in MOVE_LOG_CHUNK_SIZE appends allocates memory.
+Every entry has a timestamp: the time in milliseconds since the log was created (a monotonic clock).
+*/
+
+#define MOVE_LOG_CHUNK_SIZE 64 // the number of entries in a chunk
+
+typedef enum move_log_entry_type_e {
+	MoveLogEntryUserMove,
+	MoveLogEntryComputerMove,
+	MoveLogEntryUndo // the last move that was not undone yet was undone
+} MoveLogEntryType;
+
+/*
+An entry of the log. For an undo entry, the squares and the pieces are the ones of the undone move.
+*/
+typedef struct move_log_entry_t {
+	MoveLogEntryType type;
+	ChessPlayer player; // the player that made the move
+	BoardSquare from;
+	BoardSquare to;
+	char piece; // the piece that was moved
+	char capturedPiece; // BOARD_EMPTY_CELL if the move is not a capture
+	long long timeMs; // the time of the entry since the log was created
+	long long searchTimeMs; // computer moves only - the duration of the search
+	MinimaxStats searchStats; // computer moves only - the statistics of the search
+} MoveLogEntry;
+
+typedef struct move_log_chunk_t {
+	MoveLogEntry entries[MOVE_LOG_CHUNK_SIZE];
+	struct move_log_chunk_t * next;
+} MoveLogChunk;
+
+typedef struct move_log_t {
+	MoveLogChunk * first;
+	MoveLogChunk * last; // the chunk that the next entry is appended to (allocated when needed)
+	int size;
+	long long startTimeMs;
+} MoveLog;
+
+/**
+* Type used for returning error codes from move log functions.
+*/
+typedef enum move_log_message_t {
+	MOVE_LOG_SUCCESS,
+	MOVE_LOG_INVALID_ARGUMENT,
+	MOVE_LOG_ALLOCATION_FAILED
+} MOVE_LOG_MESSAGE;
+
+/*
+Creates an empty log, and starts its clock.
+@return the log, or NULL if malloc failed
+*/
+MoveLog * moveLogCreate();
+
+/*
+Frees the log and all its entries. Does nothing if log is NULL.
+@param log the log
+*/
+void moveLogDestroy(MoveLog * log);
+
+/*
+Adds an entry to the end of the log. The timestamp of the entry is set by the log.
+@param log the log
+@param entry the entry
+@return
+MOVE_LOG_INVALID_ARGUMENT - if log is NULL
+MOVE_LOG_ALLOCATION_FAILED - if a new chunk was needed and malloc failed (the log is not affected)
+MOVE_LOG_SUCCESS - otherwise
+*/
+MOVE_LOG_MESSAGE moveLogAppend(MoveLog * log, MoveLogEntry entry);
+
+/*
+Returns the number of entries in the log.
+@param log the log
+@return the number of entries, or -1 if log is NULL
+*/
+int moveLogSize(MoveLog * log);
+
+/*
+Returns the entry at the given index (0 is the first entry). The chunks are walked from the first one,
+so iterating over the whole log should be done with moveLogForEach.
+@param log the log
+@param index the index
+@return the entry, or an entry with from = { -1, -1 } if log is NULL or the index is out of bound
+*/
+MoveLogEntry moveLogGetAt(MoveLog * log, int index);
+
+/*
+Calls the function on all the entries of the log, by order.
+@param log the log
+@param func the function, which is given the entry, its index and the context
+@param context passed to the function as is
+*/
+void moveLogForEach(MoveLog * log, void (*func)(MoveLogEntry * entry, int index, void * context), void * context);
+
+/*
+Returns the time in milliseconds since the log was created, on the clock of the timestamps.
+@param log the log
+@return the time
+*/
+long long moveLogGetElapsedMs(MoveLog * log);
+
+/*
+Prints all the entries of the log, one per line, to the file handler (stdout or file on disk).
+@param fh the file
+@param log the log
+*/
+void moveLogPrintToFileHandler(FILE * fh, MoveLog * log);
+
+#endif
@@ -0,0 +1,229 @@
+#define _POSIX_C_SOURCE 200809L // for clock_gettime
+#include "Perft.h"
+#include <time.h>
+#include <pthread.h>
+
+#define PERFT_COUNT_BITS 56 // the count is stored in the low bits of the data word, and the depth in the rest
+
+/*
+An entry of the hash table: the data word packs the count and the depth, and the check word is the key
+XOR the data, so an entry that was torn by concurrent stores doesn't match its key (as in TranspositionTable).
+*/
+typedef struct perft_slot_t {
+	uint64_t check;
+	uint64_t data;
+} PerftSlot;
+
+typedef struct perft_table_t {
+	PerftSlot * slots;
+	uint64_t indexMask; // number of entries - 1
+} PerftTable;
+
+/*
+The state that is shared by the threads of a run.
+*/
+typedef struct perft_run_t {
+	Game * game;
+	int depth;
+	PerftTable * table; // NULL if disabled
+	PerftResult * result;
+	int nextMoveIndex; // the next root move that no thread has taken, updated atomically
+} PerftRun;
+
+typedef struct perft_worker_t {
+	PerftRun * run;
+	Game * game; // the own copy of the thread
+	pthread_t thread;
+	bool isRunning;
+} PerftWorker;
+
+static int perftThreadsNumber = 1;
+static int perftHashSizeMB = PERFT_DEFAULT_HASH_SIZE_MB;
+
+/*
+Returns the time in milliseconds from an arbitrary starting point (a monotonic clock).
+*/
+static long long perftGetTimeMs() {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/*
+Creates a zeroed table with the largest power of two of entries that fits in sizeMB.
+Returns NULL if malloc failed.
+*/
+static PerftTable * perftTableCreate(int sizeMB) {
+	PerftTable * table;
+	uint64_t entriesNumber = 1;
+
+	while (entriesNumber * 2 * sizeof(PerftSlot) <= (uint64_t)sizeMB * 1024 * 1024) entriesNumber *= 2;
+
+	table = malloc(sizeof(PerftTable));
+	if (table == NULL) return NULL;
+
+	table->slots = calloc(entriesNumber, sizeof(PerftSlot));
+	if (table->slots == NULL) {
+		free(table);
+		return NULL;
+	}
+
+	table->indexMask = entriesNumber - 1;
+
+	return table;
+}
+
+static void perftTableDestroy(PerftTable * table) {
+	if (table == NULL) return;
+
+	free(table->slots);
+	free(table);
+}
+
+/*
+Returns true and sets *count if the count of the position to the given depth is in the table.
+*/
+static bool perftTableProbe(PerftTable * table, ZobristKey key, int depth, unsigned long long * count) {
+	PerftSlot * slot = &table->slots[key & table->indexMask];
+	uint64_t data = __atomic_load_n(&slot->data, __ATOMIC_RELAXED);
+	uint64_t check = __atomic_load_n(&slot->check, __ATOMIC_RELAXED);
+
+	if ((check ^ data) != key || (int)(data >> PERFT_COUNT_BITS) != depth) return false;
+
+	*count = data & (((uint64_t)1 << PERFT_COUNT_BITS) - 1);
+
+	return true;
+}
+
+/*
+Stores the count of the position to the given depth, replacing the entry of its index.
+*/
+static void perftTableStore(PerftTable * table, ZobristKey key, int depth, unsigned long long count) {
+	PerftSlot * slot = &table->slots[key & table->indexMask];
+	uint64_t data = ((uint64_t)depth << PERFT_COUNT_BITS) | count;
+
+	// a count that doesn't fit is not stored
+	if (count >> PERFT_COUNT_BITS) return;
+
+	__atomic_store_n(&slot->data, data, __ATOMIC_RELAXED);
+	__atomic_store_n(&slot->check, key ^ data, __ATOMIC_RELAXED);
+}
+
+/*
+Counts the leaves of the tree of valid moves to the given depth (at least 1).
+The last level is not walked: its leaves are the number of valid moves ("bulk counting").
+*/
+static unsigned long long perftCountLeaves(PerftTable * table, Game * game, int depth) {
+	MoveList moveList;
+	unsigned long long count = 0;
+
+	if (depth == 1) {
+		gameGenerateMoves(game, &moveList);
+		return moveList.size;
+	}
+
+	if (table != NULL && perftTableProbe(table, game->zobristKey, depth, &count)) return count;
+
+	gameGeneratePseudoLegalMoves(game, &moveList);
+
+	for (int i = 0; i < moveList.size; i++) {
+		gameMakeMove(game, moveList.moves[i]);
+		if (!gameIsOtherPlayerChecked(game)) count += perftCountLeaves(table, game, depth - 1);
+		gameUnmakeMove(game);
+	}
+
+	if (table != NULL) perftTableStore(table, game->zobristKey, depth, count);
+
+	return count;
+}
+
+/*
+Takes root moves of the run one by one and counts their leaves, until there are no more moves.
+*/
+static void perftCountRootMoves(PerftRun * run, Game * game) {
+	int index;
+
+	while ((index = __atomic_fetch_add(&run->nextMoveIndex, 1, __ATOMIC_RELAXED)) < run->result->moves.size) {
+		if (run->depth == 1) {
+			run->result->counts[index] = 1;
+			continue;
+		}
+
+		gameMakeMove(game, run->result->moves.moves[index]);
+		run->result->counts[index] = perftCountLeaves(run->table, game, run->depth - 1);
+		gameUnmakeMove(game);
+	}
+}
+
+static void * perftWorkerThread(void * arg) {
+	PerftWorker * worker = arg;
+
+	perftCountRootMoves(worker->run, worker->game);
+
+	return NULL;
+}
+
+PERFT_MESSAGE perftRun(Game * game, int depth, PerftResult * result) {
+	PerftRun run = { .game = game, .depth = depth, .table = NULL, .result = result, .nextMoveIndex = 0 };
+	PerftWorker * workers = NULL;
+	int helpersNumber = perftThreadsNumber - 1;
+	long long startMs;
+
+	if (game == NULL || result == NULL || depth < 1 || depth > PERFT_MAX_DEPTH) return PERFT_INVALID_ARGUMENT;
+
+	if (perftHashSizeMB > 0) {
+		run.table = perftTableCreate(perftHashSizeMB);
+		if (run.table == NULL) return PERFT_ALLOCATION_FAILED;
+	}
+
+	startMs = perftGetTimeMs();
+
+	gameGenerateMoves(game, &result->moves);
+
+	if (helpersNumber > result->moves.size - 1) helpersNumber = result->moves.size - 1;
+	if (helpersNumber > 0) workers = malloc(sizeof(PerftWorker) * helpersNumber);
+	if (workers == NULL) helpersNumber = 0;
+
+	for (int i = 0; i < helpersNumber; i++) {
+		workers[i].run = &run;
+		workers[i].game = gameClone(game);
+		workers[i].isRunning = workers[i].game != NULL &&
+			pthread_create(&workers[i].thread, NULL, perftWorkerThread, &workers[i]) == 0;
+	}
+
+	perftCountRootMoves(&run, game);
+
+	for (int i = 0; i < helpersNumber; i++) {
+		if (workers[i].isRunning) pthread_join(workers[i].thread, NULL);
+
+		gameDestroy(workers[i].game);
+	}
+
+	free(workers);
+	perftTableDestroy(run.table);
+
+	result->nodes = 0;
+	for (int i = 0; i < result->moves.size; i++) result->nodes += result->counts[i];
+
+	result->timeMs = perftGetTimeMs() - startMs;
+
+	return PERFT_SUCCESS;
+}
+
+bool perftSetThreadsNumber(int threadsNumber) {
+	if (threadsNumber < 1 || threadsNumber > PERFT_MAX_THREADS_NUMBER) return false;
+
+	perftThreadsNumber = threadsNumber;
+
+	return true;
+}
+
+bool perftSetHashSize(int sizeMB) {
+	if (sizeMB < 0) return false;
+
+	perftHashSizeMB = sizeMB;
+
+	return true;
+}
@@ -0,0 +1,67 @@
+#ifndef PERFT_H_
+#define PERFT_H_
+
+#include "Game.h"
+
+/*
+Perft Summary:
+Perft (performance test) walks the tree of all the valid moves to a given depth and counts the leaves.
+The counts of a position are known for a correct move generator, so perft checks the move generation and
+the make / unmake of moves (gameMakeMove and gameUnmakeMove), and times them.
+
+The count is divided by the moves of the root ("divide"), so a wrong count can be tracked down to a move.
+The root moves may be counted by several threads (each with its own copy of the game), and the counts of
+positions that were already counted (reached by a different move order) may be taken from a hash table.
+*/
+
+#define PERFT_MAX_DEPTH GAME_MAX_SEARCH_DEPTH
+#define PERFT_MAX_THREADS_NUMBER 64
+#define PERFT_DEFAULT_HASH_SIZE_MB 0 // no hash table by default
+
+/*
+The result of a perft run: the valid moves of the root, the leaves under each of them, and the total.
+*/
+typedef struct perft_result_t {
+	MoveList moves;
+	unsigned long long counts[GAME_MAX_MOVES_NUMBER]; // indexed as moves
+	unsigned long long nodes; // the sum of the counts
+	long long timeMs;
+} PerftResult;
+
+/**
+* Type used for returning error codes from perft functions.
+*/
+typedef enum perft_message_t {
+	PERFT_SUCCESS,
+	PERFT_INVALID_ARGUMENT,
+	PERFT_ALLOCATION_FAILED
+} PERFT_MESSAGE;
+
+/*
+Counts the leaves of the tree of valid moves from the position of the game, divided by the root moves.
+The game is not changed (its undo stack must be empty).
+@param game the game
+@param depth the depth, 1 to PERFT_MAX_DEPTH
+@param result the result to fill
+@return
+PERFT_INVALID_ARGUMENT - if game or result are NULL, or the depth is out of range
+PERFT_ALLOCATION_FAILED - if the hash table was enabled and couldn't be allocated
+PERFT_SUCCESS - otherwise (if a copy of the game or a thread couldn't be created, less threads are used)
+*/
+PERFT_MESSAGE perftRun(Game * game, int depth, PerftResult * result);
+
+/*
+Sets the number of threads of a perft run.
+@param threadsNumber the number of threads (1 to PERFT_MAX_THREADS_NUMBER)
+@return true iff the number is valid (otherwise nothing is changed)
+*/
+bool perftSetThreadsNumber(int threadsNumber);
+
+/*
+Sets the size of the hash table of a perft run. The table is allocated for each run.
+@param sizeMB the size in megabytes, or 0 to disable the hash table
+@return true iff sizeMB >= 0 (otherwise nothing is changed)
+*/
+bool perftSetHashSize(int sizeMB);
+
+#endif
@@ -0,0 +1,107 @@
+#define _POSIX_C_SOURCE 200809L // for clock_gettime
+#include "Profiler.h"
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef GAME_PROFILE
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PROFILER_TICKS_UNIT "cycles"
+#else
+#define PROFILER_TICKS_UNIT "ns"
+#endif
+
+static const char * profilerCounterNames[ProfilerCountersNumber] = {
+	"gameGenerateMoves",
+	"gameGeneratePseudoLegalMoves",
+	"gameMakeMove",
+	"gameUnmakeMove",
+	"gameIsKingChecked",
+	"gameBoardKingIsChecked",
+	"gameIsSquareAttacked",
+	"gameMailboxIsSquareAttacked",
+	"gameGetLegalMoves",
+	"gameBitboardGetLegalMoves",
+	"gameMailboxGetLegalMoves",
+	"gameGetMovesByTypes",
+	"gameHandlerComputerTurn"
+};
+
+static unsigned long long profilerCalls[ProfilerCountersNumber];
+static unsigned long long profilerTicks[ProfilerCountersNumber];
+
+unsigned long long profilerGetTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+	return __builtin_ia32_rdtsc();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (unsigned long long)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+void profilerAdd(ProfilerCounter counter, unsigned long long ticks) {
+	__atomic_fetch_add(&profilerCalls[counter], 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&profilerTicks[counter], ticks, __ATOMIC_RELAXED);
+}
+
+bool profilerIsEnabled() {
+	return true;
+}
+
+void profilerReset() {
+	for (int i = 0; i < ProfilerCountersNumber; i++) {
+		__atomic_store_n(&profilerCalls[i], 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&profilerTicks[i], 0, __ATOMIC_RELAXED);
+	}
+}
+
+/*
+Compares counters by their total time, for sorting the slowest first.
+*/
+static int profilerCompareCounters(const void * a, const void * b) {
+	unsigned long long ticksA = profilerTicks[*(const int *)a], ticksB = profilerTicks[*(const int *)b];
+
+	if (ticksA == ticksB) return 0;
+
+	return ticksA > ticksB ? -1 : 1;
+}
+
+void profilerPrintToFileHandler(FILE * fh) {
+	int order[ProfilerCountersNumber];
+	unsigned long long computerMoves = profilerCalls[ProfilerComputerTurn];
+
+	for (int i = 0; i < ProfilerCountersNumber; i++) order[i] = i;
+	qsort(order, ProfilerCountersNumber, sizeof(int), profilerCompareCounters);
+
+	fprintf(fh, "%-30s %14s %20s %16s", "function", "calls", PROFILER_TICKS_UNIT, PROFILER_TICKS_UNIT "/call");
+	if (computerMoves > 0) fprintf(fh, " %16s", "calls/move");
+	fprintf(fh, "\n");
+
+	for (int i = 0; i < ProfilerCountersNumber; i++) {
+		if (profilerCalls[order[i]] == 0) continue;
+
+		fprintf(fh, "%-30s %14llu %20llu %16llu", profilerCounterNames[order[i]], profilerCalls[order[i]],
+			profilerTicks[order[i]], profilerTicks[order[i]] / profilerCalls[order[i]]);
+
+		if (computerMoves > 0) fprintf(fh, " %16llu", profilerCalls[order[i]] / computerMoves);
+		fprintf(fh, "\n");
+	}
+}
+
+#else
+
+bool profilerIsEnabled() {
+	return false;
+}
+
+void profilerReset() {
+}
+
+void profilerPrintToFileHandler(FILE * fh) {
+	fprintf(fh, "The profiler is disabled (compile with GAME_PROFILE defined)\n");
+}
+
+#endif
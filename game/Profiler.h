@@ -0,0 +1,83 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/*
+Profiler Summary:
+Call counters and timers of the hot functions of the game. Each profiled function is counted and timed
+by PROFILER_START and PROFILER_STOP, from its start to its end (so the time of a function includes the time
+of the profiled functions that it calls). The time is measured in CPU cycles (with rdtsc) on x86, and in
+nanoseconds (with a monotonic clock) elsewhere.
+
+Compiling with GAME_PROFILE defined enables the profiler (with the makefile: make PROFILE=1, after make clean).
+Otherwise PROFILER_START and PROFILER_STOP are compiled to nothing, and only the printing is left, which
+prints that the profiler is disabled.
+
+The counters are updated atomically, so the threads of a parallel search may be profiled too.
+*/
+
+/*
+The profiled functions.
+*/
+typedef enum profiler_counter_e {
+	ProfilerGameGenerateMoves,
+	ProfilerGameGeneratePseudoLegalMoves,
+	ProfilerGameMakeMove,
+	ProfilerGameUnmakeMove,
+	ProfilerGameIsKingChecked,
+	ProfilerGameBoardKingIsChecked,
+	ProfilerGameIsSquareAttacked,
+	ProfilerGameMailboxIsSquareAttacked,
+	ProfilerGameGetLegalMoves,
+	ProfilerGameBitboardGetLegalMoves,
+	ProfilerGameMailboxGetLegalMoves,
+	ProfilerGameGetMovesByTypes,
+	ProfilerComputerTurn, // the number of the computer moves, so the counts can be given per computer move
+	ProfilerCountersNumber
+} ProfilerCounter;
+
+#ifdef GAME_PROFILE
+
+// declares the start time of the counter, so it can only be started once in a block
+#define PROFILER_START(counter) unsigned long long profilerStart##counter = profilerGetTicks()
+#define PROFILER_STOP(counter) profilerAdd(counter, profilerGetTicks() - profilerStart##counter)
+
+/*
+Returns the current time in ticks (cycles or nanoseconds, see the summary).
+*/
+unsigned long long profilerGetTicks();
+
+/*
+Adds a call to the counter.
+@param counter the counter
+@param ticks the time of the call
+*/
+void profilerAdd(ProfilerCounter counter, unsigned long long ticks);
+
+#else
+
+#define PROFILER_START(counter)
+#define PROFILER_STOP(counter)
+
+#endif
+
+/*
+Returns true iff the profiler was enabled at compile time (GAME_PROFILE is defined).
+*/
+bool profilerIsEnabled();
+
+/*
+Zeroes all the counters.
+*/
+void profilerReset();
+
+/*
+Prints a table of the counters that were called, sorted by their total time (the slowest first): the calls,
+the total time and the time per call of each, and the calls per computer move if the computer has moved.
+@param fh the file (stdout or a file on disk)
+*/
+void profilerPrintToFileHandler(FILE * fh);
+
+#endif
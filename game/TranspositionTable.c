@@ -0,0 +1,98 @@
+#include "TranspositionTable.h"
+
+#define TRANSPOSITION_TABLE_MAX_AGE 63 // the age is stored in 6 bits
+
+TranspositionTable * transpositionTableCreate(int sizeMB) {
+	TranspositionTable * table;
+	uint64_t entriesNumber = 1;
+
+	if (sizeMB <= 0) return NULL;
+
+	// the largest power of two that fits
+	while (entriesNumber * 2 * sizeof(TranspositionSlot) <= (uint64_t)sizeMB * 1024 * 1024) entriesNumber *= 2;
+
+	table = malloc(sizeof(TranspositionTable));
+	if (table == NULL) return NULL;
+
+	table->slots = calloc(entriesNumber, sizeof(TranspositionSlot));
+	if (table->slots == NULL) {
+		free(table);
+		return NULL;
+	}
+
+	table->indexMask = entriesNumber - 1;
+	table->age = 1; // the entries are zeroed, so they belong to an earlier search
+
+	return table;
+}
+
+void transpositionTableDestroy(TranspositionTable * table) {
+	if (table == NULL) return;
+
+	free(table->slots);
+	free(table);
+}
+
+void transpositionTableClear(TranspositionTable * table) {
+	memset(table->slots, 0, (table->indexMask + 1) * sizeof(TranspositionSlot));
+	table->age = 1;
+}
+
+void transpositionTableNewSearch(TranspositionTable * table) {
+	table->age++;
+
+	// age 0 is reserved for empty entries
+	if (table->age > TRANSPOSITION_TABLE_MAX_AGE) table->age = 1;
+}
+
+/*
+Packs the fields of an entry (all but the key) into a data word.
+*/
+static uint64_t transpositionTablePackData(int score, GameMove bestMove, int depth, TranspositionBound bound,
+	unsigned char age) {
+
+	return (uint64_t)(uint32_t)score | ((uint64_t)bestMove << 32) | ((uint64_t)(unsigned char)depth << 48) |
+		((uint64_t)bound << 56) | ((uint64_t)age << 58);
+}
+
+/*
+Unpacks a data word into the fields of an entry (all but the key).
+*/
+static void transpositionTableUnpackData(uint64_t data, TranspositionEntry * entry) {
+	entry->score = (int)(int32_t)(uint32_t)data;
+	entry->bestMove = (GameMove)(data >> 32);
+	entry->depth = (signed char)(unsigned char)(data >> 48);
+	entry->bound = (unsigned char)((data >> 56) & 0x3);
+	entry->age = (unsigned char)(data >> 58);
+}
+
+bool transpositionTableProbe(TranspositionTable * table, ZobristKey key, TranspositionEntry * entry) {
+	TranspositionSlot * slot = &table->slots[key & table->indexMask];
+	uint64_t check = __atomic_load_n(&slot->check, __ATOMIC_RELAXED);
+	uint64_t data = __atomic_load_n(&slot->data, __ATOMIC_RELAXED);
+
+	// an empty entry, an entry of a different position or a torn entry
+	if (data == 0 || (check ^ data) != key) return false;
+
+	entry->key = key;
+	transpositionTableUnpackData(data, entry);
+
+	return true;
+}
+
+void transpositionTableStore(TranspositionTable * table, ZobristKey key, int depth,
+	TranspositionBound bound, int score, GameMove bestMove) {
+
+	TranspositionSlot * slot = &table->slots[key & table->indexMask];
+	TranspositionEntry stored;
+	uint64_t data = __atomic_load_n(&slot->data, __ATOMIC_RELAXED);
+
+	// keep a deeper result of the current search
+	transpositionTableUnpackData(data, &stored);
+	if (data != 0 && stored.age == table->age && stored.depth > depth) return;
+
+	data = transpositionTablePackData(score, bestMove, depth, bound, table->age);
+
+	__atomic_store_n(&slot->check, key ^ data, __ATOMIC_RELAXED);
+	__atomic_store_n(&slot->data, data, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,108 @@
+#ifndef TRANSPOSITION_TABLE_H_
+#define TRANSPOSITION_TABLE_H_
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Game.h"
+
+/*
+TranspositionTable Summary:
+A fixed size hash table of search results, keyed by the zobrist key of the position.
+Each entry stores the depth of the search, the score and whether it's the exact score or
+only a lower / upper bound of it (because of alpha-beta cutoffs), and the best move that was found.
+
+The number of entries is a power of two, so the index of a key is its low bits.
+Replacement policy (one entry per index): an entry is replaced if it was stored in an earlier search,
+or if the new result was searched at least as deep as the stored one.
+
+Probe and Store may be called concurrently by several threads, without locks: an entry is packed into
+a data word, and stored with a check word that is the key XOR the data. Each word is read and written
+atomically, so a probe that reads two halves of different stores (a torn entry) gets a check that doesn't
+match the key, and treats the entry as missing.
+The other functions must not be called while a search is running.
+*/
+
+#define TRANSPOSITION_TABLE_DEFAULT_SIZE_MB 16
+
+typedef enum transposition_bound_e {
+	TranspositionBoundExact,
+	TranspositionBoundLower, // the score is a lower bound (the search failed high)
+	TranspositionBoundUpper // the score is an upper bound (the search failed low)
+} TranspositionBound;
+
+/*
+An entry of the table, as returned by transpositionTableProbe.
+*/
+typedef struct transposition_entry_t {
+	ZobristKey key;
+	int score;
+	GameMove bestMove;
+	signed char depth;
+	unsigned char bound;
+	unsigned char age;
+} TranspositionEntry;
+
+/*
+An entry as it's stored in the table. The data word packs the score (bits 0-31), the best move (32-47),
+the depth (48-55), the bound (56-57) and the age (58-63).
+*/
+typedef struct transposition_slot_t {
+	uint64_t check; // the key XOR data
+	uint64_t data;
+} TranspositionSlot;
+
+typedef struct transposition_table_t {
+	TranspositionSlot * slots;
+	uint64_t indexMask; // number of entries - 1
+	unsigned char age; // 1 to 63 (6 bits)
+} TranspositionTable;
+
+/*
+Creates an empty transposition table. The number of entries is the largest power of two
+that fits in the given size.
+@param sizeMB the maximum size of the table in megabytes
+@return the table, or NULL if malloc failed or sizeMB <= 0
+*/
+TranspositionTable * transpositionTableCreate(int sizeMB);
+
+/*
+Frees all memory resources associated with the table. Does nothing if table is NULL.
+@param table the table
+*/
+void transpositionTableDestroy(TranspositionTable * table);
+
+/*
+Removes all the entries of the table.
+@param table the table
+*/
+void transpositionTableClear(TranspositionTable * table);
+
+/*
+Marks the start of a new search. Entries of earlier searches are replaced before entries of this search.
+@param table the table
+*/
+void transpositionTableNewSearch(TranspositionTable * table);
+
+/*
+Looks for the position in the table.
+@param table the table
+@param key the zobrist key of the position
+@param entry the entry to fill if the position is found
+@return true iff the position is found
+*/
+bool transpositionTableProbe(TranspositionTable * table, ZobristKey key, TranspositionEntry * entry);
+
+/*
+Stores a search result, according to the replacement policy.
+@param table the table
+@param key the zobrist key of the position
+@param depth the depth of the search
+@param bound the type of the score
+@param score the score, from the point of view of the current player of the position
+@param bestMove the best move (0 if there is no such move)
+*/
+void transpositionTableStore(TranspositionTable * table, ZobristKey key, int depth,
+	TranspositionBound bound, int score, GameMove bestMove);
+
+#endif
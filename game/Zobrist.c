@@ -0,0 +1,44 @@
+#include "Zobrist.h"
+
+#define ZOBRIST_SEED 0x9E3779B97F4A7C15ULL
+
+static ZobristKey zobristPieceKeys[2][BitboardPieceTypesNumber][64];
+static ZobristKey zobristSideKey;
+static bool zobristKeysInitialized = false;
+
+/*
+The splitmix64 generator. Updates the state and returns the next pseudo-random number.
+*/
+static ZobristKey zobristNextRandom(uint64_t * state) {
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+	return z ^ (z >> 31);
+}
+
+void zobristInitKeys() {
+	uint64_t state = ZOBRIST_SEED;
+
+	if (zobristKeysInitialized) return;
+
+	for (int player = 0; player < 2; player++) {
+		for (int pieceType = 0; pieceType < BitboardPieceTypesNumber; pieceType++) {
+			for (int i = 0; i < 64; i++) {
+				zobristPieceKeys[player][pieceType][i] = zobristNextRandom(&state);
+			}
+		}
+	}
+
+	zobristSideKey = zobristNextRandom(&state);
+	zobristKeysInitialized = true;
+}
+
+ZobristKey zobristGetPieceKey(int player, BitboardPieceType pieceType, int squareIndex) {
+	return zobristPieceKeys[player][pieceType][squareIndex];
+}
+
+ZobristKey zobristGetSideKey() {
+	return zobristSideKey;
+}
@@ -0,0 +1,39 @@
+#ifndef ZOBRIST_H_
+#define ZOBRIST_H_
+
+#include <stdint.h>
+#include "Bitboard.h"
+
+/*
+Zobrist Summary:
+Zobrist hashing gives every (player, piece type, square) a random 64-bit key, and an additional key
+for "black to move". The key of a position is the XOR of the keys of all its pieces, and the side key
+if black is the current player. Since XOR is its own inverse, the key can be updated incrementally
+when a piece is added or removed.
+
+The keys are generated by a fixed-seed generator, so they are the same in every run.
+*/
+
+typedef uint64_t ZobristKey;
+
+/*
+Initializes the keys. Must be called before any other function of this module, and before
+any concurrent use. Calling it more than once has no effect.
+*/
+void zobristInitKeys();
+
+/*
+Returns the key of a piece on a square.
+@param player the player that the piece belongs to (a ChessPlayer value)
+@param pieceType the piece type
+@param squareIndex the square index (row * 8 + col)
+@return the key
+*/
+ZobristKey zobristGetPieceKey(int player, BitboardPieceType pieceType, int squareIndex);
+
+/*
+Returns the key that is added when black is the current player.
+*/
+ZobristKey zobristGetSideKey();
+
+#endif
@@ -55,6 +55,8 @@ void graphicalGameDestroy(GraphicalGame * gg) {
 
 	// we need the next line in case user click X on save window
 	if (gg->gameWindowBeforeSaveLoad != NULL) gg->gameWindowBeforeSaveLoad->destroy(gg->gameWindowBeforeSaveLoad);
+
+	minimaxFreeResources();
 	
 	free(gg);
 }
@@ -187,7 +187,7 @@ static void handleLeftClickOnSquare(GuiGameBoard * gameBoard, BoardSquare s) {
 		}
 
 		else if (gameBoard->squareChosen.row != -1) {
-			switch (gameSetMove(gh->game, gameBoard->squareChosen, s)) {
+			switch (gameHandlerSetUserMove(gh, gameBoard->squareChosen, s)) {
 
 			case GAME_INVALID_SQUARE:
 				break;
@@ -211,8 +211,6 @@ static void handleLeftClickOnSquare(GuiGameBoard * gameBoard, BoardSquare s) {
 			default:
 				break;
 			}
-
-			gameHandlerGameElementAddedToHistory(gh);
 		}
 	}
 }
@@ -242,8 +240,8 @@ static void handleUndoEvent(GuiGameBoard * gameBoard) {
 	if (arrayListIsEmpty(gameBoard->gh->game->history)) return;
 
 	// try twice. if there is only one element, the second call does nothing
-	gameUndoPrevMove(gameBoard->gh->game);
-	gameUndoPrevMove(gameBoard->gh->game);
+	gameHandlerUndoPrevMove(gameBoard->gh);
+	gameHandlerUndoPrevMove(gameBoard->gh);
 
 	gameBoardChanged(gameBoard);
 }
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "MoveLog.h"
+
+/*
+A headless test of the move log (no SDL): appends entries across the boundaries of the chunks, and checks
+that every entry is read back by moveLogGetAt and moveLogForEach in the order of the appends, and is
+exported as a line. Exits with 1 if any check fails.
+*/
+
+#define MOVE_LOG_TEST_ENTRIES_NUMBER (2 * MOVE_LOG_CHUNK_SIZE + 1) // the last chunk has a single entry
+
+static int checksNumber = 0;
+static int failuresNumber = 0;
+
+/*
+Counts the check, and prints it if it failed.
+*/
+static void moveLogTestCheck(bool passed, char * description, int index) {
+	checksNumber++;
+	if (passed) return;
+
+	failuresNumber++;
+	printf("FAILED: %s (index %d)\n", description, index);
+}
+
+/*
+Returns an entry that is identified by its index (the duration of the search holds the index).
+*/
+static MoveLogEntry moveLogTestCreateEntry(int index) {
+	MoveLogEntry entry = { .type = MoveLogEntryComputerMove, .player = index % 2 == 0 ? White : Black,
+		.from = { index % BOARD_ROWS_NUMBER, 0 }, .to = { index % BOARD_ROWS_NUMBER, 1 },
+		.piece = PIECE_PAWN, .capturedPiece = BOARD_EMPTY_CELL, .searchTimeMs = index };
+
+	return entry;
+}
+
+/*
+Checks that the entries are visited by order. The context is the number of visited entries.
+*/
+static void moveLogTestVisitEntry(MoveLogEntry * entry, int index, void * context) {
+	int * visitedNumber = context;
+
+	moveLogTestCheck(index == *visitedNumber && entry->searchTimeMs == index, "moveLogForEach order", index);
+	(*visitedNumber)++;
+}
+
+/*
+Returns the number of lines of the file, from its start.
+*/
+static int moveLogTestCountLines(FILE * fh) {
+	int c, linesNumber = 0;
+
+	rewind(fh);
+	while ((c = fgetc(fh)) != EOF) {
+		if (c == '\n') linesNumber++;
+	}
+
+	return linesNumber;
+}
+
+int main() {
+	MoveLog * log = moveLogCreate();
+	MoveLogChunk * chunk;
+	FILE * fh;
+	int chunksNumber = 0, visitedNumber = 0;
+
+	if (log == NULL) {
+		printf("ERROR: failed to create the log.\n");
+		return 1;
+	}
+
+	moveLogTestCheck(moveLogSize(log) == 0 && log->first == NULL, "the new log is empty", 0);
+
+	for (int i = 0; i < MOVE_LOG_TEST_ENTRIES_NUMBER; i++) {
+		if (moveLogAppend(log, moveLogTestCreateEntry(i)) != MOVE_LOG_SUCCESS) {
+			printf("ERROR: failed to append to the log.\n");
+			moveLogDestroy(log);
+			return 1;
+		}
+
+		// the entry that was just appended, which is the first one of a new chunk on the boundaries
+		moveLogTestCheck(moveLogSize(log) == i + 1, "moveLogSize after an append", i);
+		moveLogTestCheck(moveLogGetAt(log, i).searchTimeMs == i, "moveLogGetAt after an append", i);
+	}
+
+	for (int i = 0; i < MOVE_LOG_TEST_ENTRIES_NUMBER; i++) {
+		moveLogTestCheck(moveLogGetAt(log, i).searchTimeMs == i, "moveLogGetAt", i);
+	}
+
+	moveLogTestCheck(moveLogGetAt(log, -1).from.row == -1, "moveLogGetAt out of bound", -1);
+	moveLogTestCheck(moveLogGetAt(log, MOVE_LOG_TEST_ENTRIES_NUMBER).from.row == -1, "moveLogGetAt out of bound",
+		MOVE_LOG_TEST_ENTRIES_NUMBER);
+
+	for (chunk = log->first; chunk != NULL; chunk = chunk->next) chunksNumber++;
+	moveLogTestCheck(chunksNumber == 3 && log->last->next == NULL, "the number of chunks", chunksNumber);
+
+	moveLogForEach(log, moveLogTestVisitEntry, &visitedNumber);
+	moveLogTestCheck(visitedNumber == MOVE_LOG_TEST_ENTRIES_NUMBER, "moveLogForEach visits all the entries",
+		visitedNumber);
+
+	fh = tmpfile();
+	if (fh != NULL) {
+		moveLogPrintToFileHandler(fh, log);
+		moveLogTestCheck(moveLogTestCountLines(fh) == MOVE_LOG_TEST_ENTRIES_NUMBER, "a line per exported entry", 0);
+		fclose(fh);
+	}
+
+	printf("%d checks, %d failed\n", checksNumber, failuresNumber);
+
+	moveLogDestroy(log);
+
+	return failuresNumber > 0 ? 1 : 0;
+}
@@ -0,0 +1,76 @@
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "GameHandler.h"
+#include "Perft.h"
+
+/*
+A headless perft run (no SDL): counts the leaves of the tree of valid moves from the initial position
+or from a saved game, and prints the count of each root move if requested, the total and the speed.
+*/
+
+static void printUsage(char * name) {
+	printf("USAGE: %s <depth> [-load <file>] [-divide] [-threads <n>] [-hash <MB>]\n", name);
+}
+
+static void printSquare(BoardSquare s) {
+	printf("<%d,%c>", s.row + 1, s.col + 'A');
+}
+
+int main(int argc, char * argv[]) {
+	GameHandler * gh;
+	PerftResult result;
+	char * path = NULL;
+	bool divide = false, error = false;
+	int depth;
+
+	if (argc < 2) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	depth = atoi(argv[1]);
+
+	for (int i = 2; i < argc && !error; i++) {
+		if (strcmp(argv[i], "-divide") == 0) divide = true;
+		else if (strcmp(argv[i], "-load") == 0 && i + 1 < argc) path = argv[++i];
+		else if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc) error = !perftSetThreadsNumber(atoi(argv[++i]));
+		else if (strcmp(argv[i], "-hash") == 0 && i + 1 < argc) error = !perftSetHashSize(atoi(argv[++i]));
+		else error = true;
+	}
+
+	if (error || depth < 1 || depth > PERFT_MAX_DEPTH) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	gh = path != NULL ? gameHandlerLoadGame(path) : gameHandlerNewGame(gameHandlerGetDefaultSettings());
+	if (gh == NULL) {
+		printf("ERROR: failed to %s the game.\n", path != NULL ? "load" : "create");
+		return 1;
+	}
+
+	if (perftRun(gh->game, depth, &result) != PERFT_SUCCESS) {
+		printf("ERROR: perft has failed.\n");
+		gameHandlerDestroy(gh);
+		return 1;
+	}
+
+	if (divide) {
+		for (int i = 0; i < result.moves.size; i++) {
+			printSquare(gameMoveGetSource(result.moves.moves[i]));
+			printf(" -> ");
+			printSquare(gameMoveGetDestination(result.moves.moves[i]));
+			printf(": %llu\n", result.counts[i]);
+		}
+	}
+
+	printf("depth %d: %llu nodes in %lldms (%.0f nodes/s)\n", depth, result.nodes, result.timeMs,
+		result.timeMs > 0 ? result.nodes * 1000.0 / result.timeMs : 0.0);
+
+	if (profilerIsEnabled()) profilerPrintToFileHandler(stdout);
+
+	gameHandlerDestroy(gh);
+
+	return 0;
+}
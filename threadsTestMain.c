@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "Minimax.h"
+
+/*
+A headless test of the parallel search (no SDL): plays games from random openings, and checks that
+the root split search with THREADS_TEST_THREADS_NUMBER threads suggests the same move as the serial
+search in every position, with the transposition table enabled (and kept between the searches, like in
+a game). Exits with 1 if any move is not the same.
+*/
+
+#define THREADS_TEST_GAMES_NUMBER 12
+#define THREADS_TEST_OPENING_PLIES 4 // the random moves of the opening of each game
+#define THREADS_TEST_MAX_PLIES 24 // the searched moves of each game
+#define THREADS_TEST_LEVEL 4
+#define THREADS_TEST_THREADS_NUMBER 4
+#define THREADS_TEST_SEED 1
+
+/*
+Returns true iff the serial and the parallel searches suggest the same move in the position of game,
+and prints them if not. The move of the serial search is returned in serialMove.
+*/
+static bool threadsTestCheckPosition(Game * game, int gameIndex, int ply, Move * serialMove) {
+	Move parallelMove;
+
+	minimaxSetThreadsNumber(1);
+	*serialMove = minimaxSuggestMove(game, THREADS_TEST_LEVEL);
+	minimaxSetThreadsNumber(THREADS_TEST_THREADS_NUMBER);
+	parallelMove = minimaxSuggestMove(game, THREADS_TEST_LEVEL);
+
+	if (serialMove->oldSquare.row == parallelMove.oldSquare.row &&
+		serialMove->oldSquare.col == parallelMove.oldSquare.col &&
+		serialMove->newSquare.row == parallelMove.newSquare.row &&
+		serialMove->newSquare.col == parallelMove.newSquare.col) return true;
+
+	printf("FAILED: game %d ply %d: the serial move is <%d,%c> -> <%d,%c>, and the parallel move <%d,%c> -> <%d,%c>\n",
+		gameIndex, ply,
+		serialMove->oldSquare.row + 1, 'A' + serialMove->oldSquare.col,
+		serialMove->newSquare.row + 1, 'A' + serialMove->newSquare.col,
+		parallelMove.oldSquare.row + 1, 'A' + parallelMove.oldSquare.col,
+		parallelMove.newSquare.row + 1, 'A' + parallelMove.newSquare.col);
+	for (int row = BOARD_ROWS_NUMBER - 1; row >= 0; row--) {
+		printf("%.*s\n", BOARD_COLUMNS_NUMBER, game->gameBoard[row]);
+	}
+
+	return false;
+}
+
+int main() {
+	Game * game;
+	MoveList moveList;
+	Move move;
+	GameMove openingMove;
+	int positions = 0, failures = 0;
+
+	srand(THREADS_TEST_SEED);
+	minimaxSetParallelMode(MinimaxParallelRootSplit);
+
+	for (int i = 0; i < THREADS_TEST_GAMES_NUMBER; i++) {
+		game = gameCreate(THREADS_TEST_OPENING_PLIES + THREADS_TEST_MAX_PLIES);
+		if (game == NULL) {
+			printf("ERROR: failed to create the game.\n");
+			minimaxFreeResources();
+			return 1;
+		}
+
+		for (int ply = 0; ply < THREADS_TEST_OPENING_PLIES; ply++) {
+			gameGenerateMoves(game, &moveList);
+			if (moveList.size == 0) break;
+
+			openingMove = moveList.moves[rand() % moveList.size];
+			gameForceSetMove(game, gameMoveGetSource(openingMove), gameMoveGetDestination(openingMove));
+		}
+
+		for (int ply = 0; ply < THREADS_TEST_MAX_PLIES && gameCheckWinner(game) == GAME_CHECK_WINNER_CONTINUE; ply++) {
+			positions++;
+			if (!threadsTestCheckPosition(game, i, ply, &move)) failures++;
+
+			gameForceSetMove(game, move.oldSquare, move.newSquare);
+		}
+
+		gameDestroy(game);
+	}
+
+	printf("%d positions, %d failed\n", positions, failures);
+
+	minimaxFreeResources();
+
+	return failures > 0 ? 1 : 0;
+}